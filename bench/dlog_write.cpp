@@ -0,0 +1,83 @@
+/** \file  dlog_write.cpp
+ *  \brief cost of the call of the deferred log
+ *  \details logs the same values by dlog::write(), by print::fmt() to the
+ *           buffer and by snprintf, prints nanoseconds per call. the ring is
+ *           drained to nowhere between the batches, draining is measured
+ *           apart
+ *
+ *  usage: dlog_write [calls] */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "io/dlog.hpp"
+
+void bsp_tx_char(char ch) { (void)ch; }
+void bsp_tx_block(const char* data, uint32_t len) { (void)data; (void)len; }
+uint32_t bsp_tx_available() { return UINT32_MAX; }
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+
+/** \brief keeps the compiler from dropping the results */
+static volatile char sink;
+
+/** \brief number of the calls between the drains, all of them fit the ring */
+#define BATCH 32
+
+/** \brief nanoseconds spent in drain() */
+static double drained = 0;
+
+/** \brief run the call over the values
+ *
+ *  \param fn    logs one value
+ *  \param calls number of the calls
+ *  \param drain drain the ring between the batches
+ *
+ *  \return nanoseconds per call */
+template <typename FN>
+static double measure(FN fn, uint32_t calls, bool drain)
+{ double wall = 0;
+
+  for (uint32_t i = 0; i < calls; i += BATCH)
+  { auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t j = 0; j < BATCH; j++) { fn(i + j); }
+
+    auto end = std::chrono::steady_clock::now();
+    wall += std::chrono::duration<double>(end - start).count();
+
+    if (drain)
+    { start = std::chrono::steady_clock::now();
+      dlog::drain();
+      end = std::chrono::steady_clock::now();
+      drained += std::chrono::duration<double>(end - start).count(); } }
+
+  return wall / calls * 1e9; }
+
+int main(int argc, char** argv)
+{ uint32_t calls = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 4000000;
+  uint32_t lost = dlog::dropped;
+
+  double binary = measure([](uint32_t i)
+  { dlog::write(PRINT_FMT("adc %u: %.3f V"), i & 7, (float)i * 0.001f); },
+  calls, true);
+
+  double text = measure([](uint32_t i)
+  { char out[64];
+    print(out, sizeof(out)).fmt(PRINT_FMT("adc %u: %.3f V"), i & 7,
+                                (float)i * 0.001f);
+    sink = out[0]; }, calls, false);
+
+  double libc = measure([](uint32_t i)
+  { char out[64];
+    snprintf(out, sizeof(out), "adc %u: %.3f V", i & 7, (float)i * 0.001f);
+    sink = out[0]; }, calls, false);
+
+  printf("logging of \"adc %%u: %%.3f V\", %u calls, ns per call\n", calls);
+  printf("dlog::write  %8.1f\n", binary);
+  printf("print::fmt   %8.1f\n", text);
+  printf("snprintf     %8.1f\n", libc);
+  printf("dlog::drain  %8.1f per record, %u dropped\n",
+         drained / calls * 1e9, dlog::dropped - lost);
+  return 0; }
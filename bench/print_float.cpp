@@ -0,0 +1,140 @@
+/** \file  print_float.cpp
+ *  \brief throughput of the floating point formatting
+ *  \details formats the same random values by print and by snprintf. fixed
+ *           precision results must be equal, shortest results must read back
+ *           to the same value. prints millions of numbers per second for
+ *           every method
+ *
+ *  usage: print_float [values] [rounds] */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "io/print.hpp"
+
+void bsp_tx_char(char ch) { (void)ch; }
+
+/** \brief keeps the compiler from dropping the results */
+static volatile char sink;
+
+/** \brief size of the output buffer */
+#define OUTPUT 4096
+
+/** \brief random values from 1e-6 to 1e9 */
+static std::vector<double> values;
+
+/** \brief run the formatter over all of the values
+ *
+ *  \param fn     formatter, returns number of the written characters
+ *  \param rounds number of the repetitions
+ *
+ *  \return millions of values per second */
+template <typename FN>
+static double measure(FN fn, uint32_t rounds)
+{ static char out[OUTPUT];
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t r = 0; r < rounds; r++)
+  { uint32_t pos = 0;
+
+    for (double v : values)
+    { if (pos > OUTPUT - 80) { pos = 0; }
+
+      pos += fn(out + pos, v); }
+
+    sink = out[0]; }
+
+  auto end = std::chrono::steady_clock::now();
+  double wall = std::chrono::duration<double>(end - start).count();
+  return (double)values.size() * rounds / wall / 1e6; }
+
+/** \brief compare print with snprintf for one format
+ *
+ *  \param name   name of the format
+ *  \param mine   formatter by print
+ *  \param libc   formatter by snprintf
+ *  \param check  checks the result of print by the result of snprintf
+ *  \param rounds number of the repetitions */
+template <typename MINE, typename LIBC, typename CHECK>
+static void run(const char* name, MINE mine, LIBC libc, CHECK check,
+                uint32_t rounds)
+{ bool ok = true;
+
+  for (double v : values)
+  { char a[80] = { 0 };
+    char b[80] = { 0 };
+    mine(a, v);
+    libc(b, v);
+    ok = ok && check(a, b, v); }
+
+  double fast = measure(mine, rounds);
+  double slow = measure(libc, rounds);
+  printf("%-12s %10.1f %10.1f %7.1fx %s\n", name, fast, slow, fast / slow,
+         (ok) ? "ok" : "MISMATCH"); }
+
+/** \brief results are the same */
+static bool same(const char* a, const char* b, double v)
+{ (void)v;
+  return !strcmp(a, b); }
+
+int main(int argc, char** argv)
+{ uint32_t count = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000;
+  uint32_t rounds = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 100;
+  srand(1);
+
+  for (uint32_t i = 0; i < count; i++)
+  { double v = (double)rand() / RAND_MAX;
+
+    for (int32_t e = rand() % 16 - 6; e > 0; e--) { v *= 10; }
+
+    for (int32_t e = rand() % 16 - 6; e < 0; e++) { v /= 10; }
+
+    values.push_back((rand() & 1) ? v : -v); }
+
+  printf("floating point formatting, %u values x %u rounds, "
+         "millions per second\n", count, rounds);
+  printf("format            print   snprintf  speedup\n");
+
+  run("%.2f",
+      [](char* out, double v)
+      { print p(out, 80);
+        p.f(v).t();
+        return (uint32_t)strlen(out); },
+      [](char* out, double v)
+      { return (uint32_t)snprintf(out, 80, "%.2f", v); },
+      same, rounds);
+
+  run("%.6f",
+      [](char* out, double v)
+      { print p(out, 80);
+        p.f(v, 6).t();
+        return (uint32_t)strlen(out); },
+      [](char* out, double v)
+      { return (uint32_t)snprintf(out, 80, "%.6f", v); },
+      same, rounds);
+
+  run("float %.3f",
+      [](char* out, double v)
+      { print p(out, 80);
+        p.f((float)v, 3).t();
+        return (uint32_t)strlen(out); },
+      [](char* out, double v)
+      { return (uint32_t)snprintf(out, 80, "%.3f", (double)(float)v); },
+      same, rounds);
+
+  run("shortest",
+      [](char* out, double v)
+      { print p(out, 80);
+        p.f(v, PRINT_SHORTEST).t();
+        return (uint32_t)strlen(out); },
+      [](char* out, double v)
+      { return (uint32_t)snprintf(out, 80, "%.17g", v); },
+      [](const char* a, const char* b, double v)
+      { (void)b;
+        return strtod(a, nullptr) == v; },
+      rounds);
+
+  return 0; }
@@ -0,0 +1,135 @@
+/** \file  print_integer.cpp
+ *  \brief throughput of the integer formatting
+ *  \details formats the same random values by print and by snprintf, checks
+ *           that the results are equal and prints millions of numbers per
+ *           second for every method
+ *
+ *  usage: print_integer [values] [rounds] */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "io/print.hpp"
+
+void bsp_tx_char(char ch) { (void)ch; }
+
+/** \brief keeps the compiler from dropping the results */
+static volatile char sink;
+
+/** \brief size of the output buffer */
+#define OUTPUT 4096
+
+/** \brief random values with uniformly distributed number of digits */
+static std::vector<uint64_t> values;
+
+/** \brief run the formatter over all of the values
+ *
+ *  \param fn     formatter, returns number of the written characters
+ *  \param rounds number of the repetitions
+ *
+ *  \return millions of values per second */
+template <typename FN>
+static double measure(FN fn, uint32_t rounds)
+{ static char out[OUTPUT];
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t r = 0; r < rounds; r++)
+  { uint32_t pos = 0;
+
+    for (uint64_t v : values)
+    { if (pos > OUTPUT - 80) { pos = 0; }
+
+      pos += fn(out + pos, v); }
+
+    sink = out[0]; }
+
+  auto end = std::chrono::steady_clock::now();
+  double wall = std::chrono::duration<double>(end - start).count();
+  return (double)values.size() * rounds / wall / 1e6; }
+
+/** \brief compare print with snprintf for one format
+ *
+ *  \param name   name of the format
+ *  \param mine   formatter by print
+ *  \param libc   formatter by snprintf
+ *  \param rounds number of the repetitions */
+template <typename MINE, typename LIBC>
+static void run(const char* name, MINE mine, LIBC libc, uint32_t rounds)
+{ bool ok = true;
+
+  for (uint64_t v : values)
+  { char a[80] = { 0 };
+    char b[80] = { 0 };
+    mine(a, v);
+    libc(b, v);
+    ok = ok && !strcmp(a, b); }
+
+  double fast = measure(mine, rounds);
+  double slow = measure(libc, rounds);
+  printf("%-12s %10.1f %10.1f %7.1fx %s\n", name, fast, slow, fast / slow,
+         (ok) ? "ok" : "MISMATCH"); }
+
+int main(int argc, char** argv)
+{ uint32_t count = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000;
+  uint32_t rounds = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 200;
+  srand(1);
+
+  for (uint32_t i = 0; i < count; i++)
+  { uint64_t v = ((uint64_t)rand() << 32) ^ ((uint64_t)rand() << 16) ^ rand();
+    values.push_back(v >> (rand() % 64)); }
+
+  printf("integer formatting, %u values x %u rounds, millions per second\n",
+         count, rounds);
+  printf("format            print   snprintf  speedup\n");
+
+  run("u32",
+      [](char* out, uint64_t v)
+      { print p(out, 80);
+        p.u((uint32_t)v).t();
+        return (uint32_t)strlen(out); },
+      [](char* out, uint64_t v)
+      { return (uint32_t)snprintf(out, 80, "%" PRIu32, (uint32_t)v); },
+      rounds);
+
+  run("u64",
+      [](char* out, uint64_t v)
+      { print p(out, 80);
+        p.u(v).t();
+        return (uint32_t)strlen(out); },
+      [](char* out, uint64_t v)
+      { return (uint32_t)snprintf(out, 80, "%" PRIu64, v); },
+      rounds);
+
+  run("i64",
+      [](char* out, uint64_t v)
+      { print p(out, 80);
+        p.i((int64_t)(v * 0x9E3779B97F4A7C15ULL)).t();
+        return (uint32_t)strlen(out); },
+      [](char* out, uint64_t v)
+      { return (uint32_t)snprintf(out, 80, "%" PRId64,
+                                  (int64_t)(v * 0x9E3779B97F4A7C15ULL)); },
+      rounds);
+
+  run("x64",
+      [](char* out, uint64_t v)
+      { print p(out, 80);
+        p.x(v).t();
+        return (uint32_t)strlen(out); },
+      [](char* out, uint64_t v)
+      { return (uint32_t)snprintf(out, 80, "%" PRIx64, v); },
+      rounds);
+
+  run("o64",
+      [](char* out, uint64_t v)
+      { print p(out, 80);
+        p.o(v).t();
+        return (uint32_t)strlen(out); },
+      [](char* out, uint64_t v)
+      { return (uint32_t)snprintf(out, 80, "%" PRIo64, v); },
+      rounds);
+
+  return 0; }
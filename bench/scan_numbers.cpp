@@ -0,0 +1,271 @@
+/** \file  scan_numbers.cpp
+ *  \brief throughput of the number parsing
+ *  \details parses the same comma separated text by scan and by strtoul,
+ *           strtoll and strtod, checks that the results are equal and prints
+ *           millions of numbers per second for every method
+ *
+ *  usage: scan_numbers [values] [rounds] */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "io/scan.hpp"
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+
+/** \brief keeps the compiler from dropping the results */
+static volatile uint64_t sink;
+
+/** \brief run the parser over the text
+ *
+ *  \param fn     parser, returns sum of the values
+ *  \param count  number of the values in the text
+ *  \param rounds number of the repetitions
+ *
+ *  \return millions of values per second */
+template <typename FN>
+static double measure(FN fn, uint32_t count, uint32_t rounds)
+{ auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t r = 0; r < rounds; r++) { sink = fn(); }
+
+  auto end = std::chrono::steady_clock::now();
+  double wall = std::chrono::duration<double>(end - start).count();
+  return (double)count * rounds / wall / 1e6; }
+
+/** \brief compare scan with libc for one format
+ *
+ *  \param name   name of the format
+ *  \param count  number of the values
+ *  \param mine   parser by scan
+ *  \param libc   parser by libc
+ *  \param rounds number of the repetitions */
+template <typename MINE, typename LIBC>
+static void run(const char* name, uint32_t count, MINE mine, LIBC libc,
+                uint32_t rounds)
+{ bool ok = mine() == libc();
+  double fast = measure(mine, count, rounds);
+  double slow = measure(libc, count, rounds);
+  printf("%-12s %10.1f %10.1f %7.1fx %s\n", name, fast, slow, fast / slow,
+         (ok) ? "ok" : "MISMATCH"); }
+
+/** \brief make the comma separated text of the values
+ *
+ *  \param count  number of the values
+ *  \param format printf format of one value
+ *  \param value  makes the value by its index */
+template <typename FN>
+static std::string make(uint32_t count, const char* format, FN value)
+{ std::string text;
+  char item[64];
+
+  for (uint32_t i = 0; i < count; i++)
+  { snprintf(item, sizeof(item), format, value(i));
+    text += item;
+    text += ','; }
+
+  return text; }
+
+/** \brief random 64 bit value with uniformly distributed number of digits */
+static uint64_t random64()
+{ uint64_t v = ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ rand();
+  return v >> (rand() % 64); }
+
+int main(int argc, char** argv)
+{ uint32_t count = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 10000;
+  uint32_t rounds = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 200;
+  srand(1);
+
+  printf("number parsing, %u values x %u rounds, millions per second\n",
+         count, rounds);
+  printf("format             scan       libc  speedup\n");
+
+  std::string u32 = make(count, "%" PRIu32, [](uint32_t)
+  { return (uint32_t)random64(); });
+  run("u32", count,
+      [&]()
+      { scan in(u32.data(), (uint32_t)u32.size());
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { uint32_t v = 0;
+          in.u(v)(',');
+          sum += v; }
+
+        return sum; },
+      [&]()
+      { const char* s = u32.data();
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { char* end;
+          sum += (uint32_t)strtoul(s, &end, 10);
+          s = end + 1; }
+
+        return sum; }, rounds);
+
+  std::string u64 = make(count, "%" PRIu64, [](uint32_t)
+  { return random64(); });
+  run("u64", count,
+      [&]()
+      { scan in(u64.data(), (uint32_t)u64.size());
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { uint64_t v = 0;
+          in.u(v)(',');
+          sum += v; }
+
+        return sum; },
+      [&]()
+      { const char* s = u64.data();
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { char* end;
+          sum += strtoull(s, &end, 10);
+          s = end + 1; }
+
+        return sum; }, rounds);
+
+  std::string i64 = make(count, "%" PRId64, [](uint32_t)
+  { return (int64_t)(random64() * 0x9E3779B97F4A7C15ULL) >> (rand() % 64); });
+  run("i64", count,
+      [&]()
+      { scan in(i64.data(), (uint32_t)i64.size());
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { int64_t v = 0;
+          in.i(v)(',');
+          sum += (uint64_t)v; }
+
+        return sum; },
+      [&]()
+      { const char* s = i64.data();
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { char* end;
+          sum += (uint64_t)strtoll(s, &end, 10);
+          s = end + 1; }
+
+        return sum; }, rounds);
+
+  std::string x64 = make(count, "%" PRIx64, [](uint32_t)
+  { return random64(); });
+  run("x64", count,
+      [&]()
+      { scan in(x64.data(), (uint32_t)x64.size());
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { uint64_t v = 0;
+          in.x(v)(',');
+          sum += v; }
+
+        return sum; },
+      [&]()
+      { const char* s = x64.data();
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { char* end;
+          sum += strtoull(s, &end, 16);
+          s = end + 1; }
+
+        return sum; }, rounds);
+
+  std::string f3 = make(count, "%.3f", [](uint32_t)
+  { return (double)(rand() % 2000000 - 1000000) / 1000; });
+  run("float %.3f", count,
+      [&]()
+      { scan in(f3.data(), (uint32_t)f3.size());
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { float v = 0;
+          in.f(v)(',');
+          uint32_t bits;
+          memcpy(&bits, &v, sizeof(bits));
+          sum += bits; }
+
+        return sum; },
+      [&]()
+      { const char* s = f3.data();
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { char* end;
+          float v = strtof(s, &end);
+          uint32_t bits;
+          memcpy(&bits, &v, sizeof(bits));
+          sum += bits;
+          s = end + 1; }
+
+        return sum; }, rounds);
+
+  std::string d6 = make(count, "%.6f", [](uint32_t)
+  { return (double)(rand() % 2000000 - 1000000) / 7; });
+  run("double %.6f", count,
+      [&]()
+      { scan in(d6.data(), (uint32_t)d6.size());
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { double v = 0;
+          in.f(v)(',');
+          uint64_t bits;
+          memcpy(&bits, &v, sizeof(bits));
+          sum += bits; }
+
+        return sum; },
+      [&]()
+      { const char* s = d6.data();
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { char* end;
+          double v = strtod(s, &end);
+          uint64_t bits;
+          memcpy(&bits, &v, sizeof(bits));
+          sum += bits;
+          s = end + 1; }
+
+        return sum; }, rounds);
+
+  std::string d17 = make(count, "%.17g", [](uint32_t)
+  { return (double)random64() / (double)random64(); });
+  run("double %.17g", count,
+      [&]()
+      { scan in(d17.data(), (uint32_t)d17.size());
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { double v = 0;
+          in.f(v)(',');
+          uint64_t bits;
+          memcpy(&bits, &v, sizeof(bits));
+          sum += bits; }
+
+        return sum; },
+      [&]()
+      { const char* s = d17.data();
+        uint64_t sum = 0;
+
+        for (uint32_t i = 0; i < count; i++)
+        { char* end;
+          double v = strtod(s, &end);
+          uint64_t bits;
+          memcpy(&bits, &v, sizeof(bits));
+          sum += bits;
+          s = end + 1; }
+
+        return sum; }, rounds);
+
+  return 0; }
@@ -0,0 +1,94 @@
+/** \file  serializer_swap.cpp
+ *  \brief throughput of the byte order conversion of the sample arrays
+ *  \details compares element by element serialization with hn(), plain
+ *           scalar swap loop and typed array av(). results of every variant
+ *           are checked against the element by element one
+ *
+ *  usage: serializer_swap [samples] [rounds] */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "tools/serializer.hpp"
+
+/** \brief keeps the compiler from dropping the results */
+static volatile uint8_t sink;
+
+/** \brief run the variant and return its throughput
+ *
+ *  \param fn     variant
+ *  \param bytes  size of the data
+ *  \param rounds number of the repetitions
+ *
+ *  \return megabytes per second */
+template <typename FN>
+static double measure(FN fn, uint32_t bytes, uint32_t rounds)
+{ auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t r = 0; r < rounds; r++) { fn(); }
+
+  auto end = std::chrono::steady_clock::now();
+  double wall = std::chrono::duration<double>(end - start).count();
+  return (double)bytes * rounds / wall / 1e6; }
+
+/** \brief compare all of the variants for one type
+ *
+ *  \tparam TYPE    type of the samples
+ *  \param  name    name of the type
+ *  \param  samples number of the samples
+ *  \param  rounds  number of the repetitions */
+template <typename TYPE>
+static void run(const char* name, uint32_t samples, uint32_t rounds)
+{ uint32_t bytes = samples * sizeof(TYPE);
+  std::vector<TYPE> values(samples);
+  std::vector<uint8_t> expected(bytes);
+  std::vector<uint8_t> buffer(bytes);
+  uint8_t* raw = (uint8_t*)values.data();
+
+  for (uint32_t i = 0; i < bytes; i++) { raw[i] = (uint8_t)(i * 7 + 1); }
+
+  auto reference = [&]()
+  { serializer out(expected.data(), bytes);
+    out.hn();
+
+    for (uint32_t i = 0; i < samples; i++) { out.v<TYPE>(values[i]); }
+
+    sink = expected[bytes - 1]; };
+
+  auto scalar = [&]()
+  { for (uint32_t i = 0; i < samples; i++)
+    { uint8_t* dst = buffer.data() + i * sizeof(TYPE);
+      memcpy(dst, &values[i], sizeof(TYPE));
+      byte_swap<sizeof(TYPE)>(dst); }
+
+    sink = buffer[bytes - 1]; };
+
+  auto typed = [&]()
+  { serializer out(buffer.data(), bytes);
+    out.hn().av<TYPE>(values.data(), samples);
+    sink = buffer[bytes - 1]; };
+
+  double ref = measure(reference, bytes, rounds);
+  bool ok = true;
+  double loop = measure(scalar, bytes, rounds);
+  ok = ok && !memcmp(expected.data(), buffer.data(), bytes);
+  std::fill(buffer.begin(), buffer.end(), 0);
+  double vec = measure(typed, bytes, rounds);
+  ok = ok && !memcmp(expected.data(), buffer.data(), bytes);
+  printf("%-9s %8u %10.0f %10.0f %10.0f %7.1fx %s\n", name, samples, ref, loop,
+         vec, vec / ref, (ok) ? "ok" : "MISMATCH"); }
+
+int main(int argc, char** argv)
+{ uint32_t samples = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 4096;
+  uint32_t rounds = (argc > 2) ? strtoul(argv[2], nullptr, 10) : 20000;
+
+  printf("byte order conversion, %u rounds, MB/s\n", rounds);
+  printf("type       samples  v() loop  bswap loop       av()  speedup\n");
+  run<uint16_t>("uint16_t", samples, rounds);
+  run<int32_t>("int32_t", samples, rounds);
+  run<float>("float", samples, rounds);
+  run<uint64_t>("uint64_t", samples, rounds);
+  return 0; }
@@ -0,0 +1,187 @@
+/** \file  sysbus_ring.cpp
+ *  \brief throughput and latency benchmark of the system bus ring
+ *  \details runs the simulated ring of different sizes with different mix
+ *           of unicast and broadcast traffic and prints delivered messages
+ *           per second, end-to-end latency percentiles and number of frame
+ *           transmissions per message. messages rejected by the full
+ *           transmission queue are counted as busy, so the loss shows only
+ *           the link errors. time is converted to seconds as for
+ *           115200 baud link with 10 bits per byte
+ *
+ *  usage: sysbus_ring [steps] [load] [ber] */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "bsp/bsp.h"
+#include "core/errcode.hpp"
+#include "core/sysbus.hpp"
+#include "tools/serializer.hpp"
+#include "bench/sysbus_sim.hpp"
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+void bsp_sysbus_tx(uint8_t byte) { (void)byte; }
+
+/** \brief maximum number of devices in the ring */
+#define MAX_DEVICES 16
+
+/** \brief size of the payload of the test message */
+#define PAYLOAD 8
+
+/** \brief duration of one byte on the link in microseconds */
+#define BYTE_TIME_US (10.0 * 1000000.0 / 115200.0)
+
+/** \brief ttl of all of the messages, enough for the largest ring */
+#define TTL (MAX_DEVICES - 1)
+
+/** \brief results of one run */
+class bench_stats
+{ public:
+    /** \brief time of sending of every message */
+    std::vector<uint64_t> sent;
+
+    /** \brief latency of every delivery */
+    std::vector<uint64_t> latency;
+
+    /** \brief number of deliveries that should be */
+    uint64_t expected;
+
+    /** \brief number of messages rejected by the full transmission queue */
+    uint64_t busy; };
+
+static sim_ring ring(MAX_DEVICES);
+static bench_stats stats;
+
+/** \brief node that measures delivery of the messages */
+class bench_node : public i_sysbus_node
+{ public:
+    bench_node(sysbus& bus, uint8_t address) : i_sysbus_node(bus)
+    { addr = address; subscribe(0); }
+
+    virtual void handler(uint8_t* data, uint8_t size, uint16_t src) override
+    { (void)src;
+      uint32_t id = 0;
+      deserializer in(data, size);
+      in.v<uint32_t>(id);
+
+      if (in.errcode || id >= stats.sent.size()) { return; }
+
+      stats.latency.push_back(ring.now - stats.sent[id]); } };
+
+/** \brief percentile of the sorted values */
+static double percentile(std::vector<uint64_t>& v, double p)
+{ if (v.empty()) { return 0; }
+
+  return (double)v[(size_t)(p * (v.size() - 1))]; }
+
+/** \brief run one configuration and print the results
+ *
+ *  \param nodes     nodes of the devices
+ *  \param devices   number of the devices in the ring
+ *  \param broadcast part of the broadcast messages
+ *  \param load      offered utilization of the links
+ *  \param ber       bit error rate
+ *  \param steps     duration of the run in byte times */
+static void run(std::vector<bench_node*>& nodes,
+                uint32_t devices,
+                double broadcast,
+                double load,
+                double ber,
+                uint64_t steps)
+{ ring.setup(devices, 2, ber, 12345);
+  stats.sent.clear();
+  stats.latency.clear();
+  stats.expected = 0;
+  stats.busy = 0;
+  sim_random random(devices * 1000 + (uint32_t)(broadcast * 100));
+
+  // every message takes one link per hop, unicast makes devices / 2 hops in
+  // average and broadcast makes full circle
+  double frame = SYSBUS_HEADER_SIZE + PAYLOAD + SYSBUS_CSUM_SIZE;
+  double hops = (1 - broadcast) * devices / 2.0 + broadcast * devices;
+  double rate = load / (frame * hops);
+
+  // receivers start out of sync and may take a part of the first frame for
+  // a shorter frame. empty frame is the shortest one, so one such frame per
+  // link synchronizes the receivers before the run
+  for (uint32_t i = 0; i < devices; i++)
+  { uint8_t empty = 0;
+    nodes[i]->signal(&empty, 0, nodes[(i + 1) % devices]->addr, TTL); }
+
+  for (uint32_t t = 0; t < 1000; t++) { ring.step(); }
+
+  uint64_t warmup = ring.bytes();
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint64_t t = 0; t < steps; t++)
+  { for (uint32_t i = 0; i < devices; i++)
+    { if (random.real() >= rate) { continue; }
+
+      uint8_t data[PAYLOAD] = { 0 };
+      serializer out(data, sizeof(data));
+      out.v<uint32_t>((uint32_t)stats.sent.size());
+      uint8_t dst = SYSBUS_BROADCAST;
+      uint32_t receivers = devices - 1;
+
+      if (random.real() >= broadcast)
+      { uint32_t shift = 1 + random.next() % (devices - 1);
+        dst = nodes[(i + shift) % devices]->addr;
+        receivers = 1; }
+
+      // message rejected by the full queue is never sent, so it's not lost
+      if (nodes[i]->signal(data, sizeof(data), dst, TTL) != ERR_OK)
+      { stats.busy++;
+        continue; }
+
+      stats.sent.push_back(ring.now);
+      stats.expected += receivers; }
+
+    ring.step(); }
+
+  // let the ring deliver the rest
+  for (uint32_t t = 0; t < 10000; t++) { ring.step(); }
+
+  auto end = std::chrono::steady_clock::now();
+  double wall = std::chrono::duration<double>(end - start).count();
+  std::sort(stats.latency.begin(), stats.latency.end());
+  double seconds = steps * BYTE_TIME_US / 1000000.0;
+  double delivered = (double)stats.latency.size();
+  double loss = (stats.expected)
+                ? 100.0 * (stats.expected - delivered) / stats.expected : 0;
+  double transmissions = (ring.bytes() - warmup) / frame;
+  double overhead = (stats.sent.size())
+                    ? transmissions / stats.sent.size() : 0;
+  printf("%7u %6.0f%% %8zu %6llu %9.0f %6.2f%% %9.0f %8.0f %8.0f %8.0f %7.2f "
+         "%7.2f\n",
+         devices, broadcast * 100, stats.sent.size(),
+         (unsigned long long)stats.busy, delivered, loss,
+         delivered / seconds,
+         percentile(stats.latency, 0.5) * BYTE_TIME_US,
+         percentile(stats.latency, 0.9) * BYTE_TIME_US,
+         percentile(stats.latency, 0.99) * BYTE_TIME_US,
+         overhead, (ring.now / wall) / 1000000.0); }
+
+int main(int argc, char** argv)
+{ uint64_t steps = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 200000;
+  double load = (argc > 2) ? strtod(argv[2], nullptr) : 0.5;
+  double ber = (argc > 3) ? strtod(argv[3], nullptr) : 0;
+  std::vector<bench_node*> nodes;
+
+  for (uint32_t i = 0; i < MAX_DEVICES; i++)
+  { nodes.push_back(new bench_node(ring.dev[i], (uint8_t)(0x10 + i))); }
+
+  printf("sysbus ring: %llu byte times, link load %.2f, ber %g\n",
+         (unsigned long long)steps, load, ber);
+  printf("devices  bcast     sent   busy delivered   loss     msg/s"
+         "  p50, us  p90, us  p99, us  tx/msg  Msteps/s\n");
+  uint32_t sizes[] = { 2, 4, 8, 16 };
+  double mixes[] = { 0, 0.25, 1 };
+
+  for (uint32_t size : sizes)
+  { for (double mix : mixes) { run(nodes, size, mix, load, ber, steps); } }
+
+  return 0; }
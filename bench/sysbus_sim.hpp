@@ -0,0 +1,191 @@
+/** \file  sysbus_sim.hpp
+ *  \brief simulator of the ring of devices connected by the system bus
+ *  \details every device is a separate sysbus object with its own nodes.
+ *           devices are connected by one direction links, as in the real
+ *           ring. time is measured in byte times of the link, every step of
+ *           the simulation moves one byte through every link. this is host
+ *           tool, it uses standard library */
+
+#ifndef SYSBUS_SIM_HPP
+#define SYSBUS_SIM_HPP
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "core/sysbus.hpp"
+
+/** \brief simple deterministic random number generator */
+class sim_random
+{ public:
+    explicit sim_random(uint32_t seed) : state(seed ? seed : 1) {}
+
+    /** \brief next random value */
+    uint32_t next()
+    { state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      return state; }
+
+    /** \brief random value in [0, 1) */
+    double real() { return (next() >> 8) / 16777216.0; }
+
+  private:
+    /** \brief state of the generator */
+    uint32_t state; };
+
+/** \brief one direction link between two neighbour devices */
+class sim_link
+{ public:
+    sim_link() : latency(0), ber(0), random(1), free_at(0), bytes(0),
+      corrupted(0) {}
+
+    /** \brief   put the block on the wire
+     *  \details bytes follow one by one, each one takes one step
+     *
+     *  \param now  current time
+     *  \param data pointer to the block
+     *  \param len  size of the block
+     *
+     *  \return time when the last byte leaves the transmitter */
+    uint64_t send(uint64_t now, const uint8_t* data, uint32_t len)
+    { uint64_t start = (free_at > now) ? free_at : now;
+
+      for (uint32_t i = 0; i < len; i++)
+      { uint8_t byte = data[i];
+
+        for (uint32_t bit = 0; ber > 0 && bit < 8; bit++)
+        { if (random.real() < ber) { byte ^= (uint8_t)(1 << bit); } }
+
+        if (byte != data[i]) { corrupted++; }
+
+        wire.push_back(std::make_pair(start + i + 1 + latency, byte)); }
+
+      bytes += len;
+      free_at = start + len;
+      return free_at; }
+
+    /** \brief delay of the byte in the link, in byte times */
+    uint32_t latency;
+
+    /** \brief bit error rate */
+    double ber;
+
+    /** \brief source of the bit errors */
+    sim_random random;
+
+    /** \brief bytes on the wire with their arrival time */
+    std::deque<std::pair<uint64_t, uint8_t>> wire;
+
+    /** \brief time when the transmitter is free */
+    uint64_t free_at;
+
+    /** \brief total number of transmitted bytes */
+    uint64_t bytes;
+
+    /** \brief number of corrupted bytes */
+    uint64_t corrupted; };
+
+/** \brief virtual device, its bus transmits to the link */
+class sim_device : public sysbus
+{ public:
+    sim_device() : link(nullptr), clock(nullptr), done_at(0), pending(false),
+      blocks(0) {}
+
+    virtual void tx(const uint8_t* data, uint32_t len) override
+    { done_at = link->send(*clock, data, len);
+      pending = true;
+      blocks++; }
+
+    /** \brief output link of the device */
+    sim_link* link;
+
+    /** \brief current time of the simulation */
+    uint64_t* clock;
+
+    /** \brief time when the current block is transmitted */
+    uint64_t done_at;
+
+    /** \brief block is being transmitted */
+    bool pending;
+
+    /** \brief number of transmitted blocks */
+    uint64_t blocks; };
+
+/** \brief ring of virtual devices */
+class sim_ring
+{ public:
+    /** \brief constructor
+     *
+     *  \param max maximum number of the devices */
+    explicit sim_ring(uint32_t max) : now(0), size(0), dev(max), links(max) {}
+
+    /** \brief   connect first devices to the ring and reset their state
+     *
+     *  \param devices number of devices in the ring
+     *  \param latency delay of every link in byte times
+     *  \param ber     bit error rate of every link
+     *  \param seed    seed of the bit errors */
+    void setup(uint32_t devices, uint32_t latency, double ber, uint32_t seed)
+    { now = 0;
+      size = (devices < dev.size()) ? devices : (uint32_t)dev.size();
+
+      for (uint32_t i = 0; i < dev.size(); i++)
+      { links[i] = sim_link();
+        links[i].latency = latency;
+        links[i].ber = ber;
+        links[i].random = sim_random(seed + i);
+        dev[i].link = &links[i];
+        dev[i].clock = &now;
+        dev[i].pending = false;
+        dev[i].blocks = 0;
+        dev[i].parser.reset();
+        dev[i].forget();
+
+        while (dev[i].rx_queue.pop_tail()) {}
+
+        for (uint8_t p = 0; p < SYSBUS_PRIORITIES; p++)
+        { while (dev[i].tx_queue[p].pop_tail()) {} }
+
+        dev[i].tx_done(); } }
+
+    /** \brief   one step of the simulation
+     *  \details delivers arrived bytes, completes transmissions and polls
+     *           every device */
+    void step()
+    { now++;
+
+      for (uint32_t i = 0; i < size; i++)
+      { std::deque<std::pair<uint64_t, uint8_t>>& wire = links[i].wire;
+
+        while (!wire.empty() && wire.front().first <= now)
+        { dev[(i + 1) % size].rx(wire.front().second);
+          wire.pop_front(); } }
+
+      for (uint32_t i = 0; i < size; i++)
+      { if (dev[i].pending && dev[i].done_at <= now)
+        { dev[i].pending = false;
+          dev[i].tx_done(); }
+
+        dev[i].poll(); } }
+
+    /** \brief total number of bytes transmitted by all of the links */
+    uint64_t bytes() const
+    { uint64_t total = 0;
+
+      for (uint32_t i = 0; i < size; i++) { total += links[i].bytes; }
+
+      return total; }
+
+    /** \brief current time */
+    uint64_t now;
+
+    /** \brief number of the devices in the ring */
+    uint32_t size;
+
+    /** \brief devices */
+    std::vector<sim_device> dev;
+
+    /** \brief links, link i goes from device i to the next one */
+    std::vector<sim_link> links; };
+
+#endif // SYSBUS_SIM_HPP
@@ -26,6 +26,25 @@ void bsp_leave_critical();
  *  \details you should guarantee that the character will be transmitted */
 void bsp_tx_char(char ch);
 
+/** \brief   transmit block of chars via service interface
+ *  \details you should guarantee that all of the characters will be
+ *           transmitted, the block may be reused right after the call.
+ *           implement it if your console can use dma or write several
+ *           characters with one system call. default implementation sends
+ *           characters one by one with bsp_tx_char()
+ *
+ *  \param data pointer to the characters
+ *  \param len  number of the characters */
+void bsp_tx_block(const char* data, uint32_t len);
+
+/** \brief   free space of the service interface
+ *  \details used by non-blocking console output to drop the data instead of
+ *           waiting. default implementation reports unlimited space
+ *
+ *  \return number of the characters that can be transmitted without
+ *          blocking */
+uint32_t bsp_tx_available();
+
 /** \brief   receive char via service interface
  *  \details as the service interface is human readable console
  *           you can use zero as no character at present moment
@@ -35,6 +54,14 @@ char bsp_rx_char();
 /** \brief   request for force sent of bufferized data */
 void bsp_tx_flush();
 
+/** \brief   free running counter for the profiling
+ *  \details any units may be used, cpu cycles are the best. it's used to
+ *           measure execution time of the handlers of the system bus.
+ *           default implementation always returns zero
+ *
+ *  \return current value of the counter */
+uint32_t bsp_timestamp();
+
 /** \brief   transmit data via system bus
  *  \details generally external system bus is a network with circle loop,
  *           this is output to next device
@@ -42,15 +69,31 @@ void bsp_tx_flush();
  *  \param byte byte to transmit */
 void bsp_sysbus_tx(uint8_t byte);
 
+/** \brief   start transmission of the data block via system bus
+ *  \details the block stays untouched until bsp_sysbus_tx_done_cb() is
+ *           called, so it can be sent by dma or by one system call. call
+ *           bsp_sysbus_tx_done_cb() when the last byte is gone, you can call
+ *           it in the interrupt or right inside this function. default
+ *           implementation sends bytes one by one with bsp_sysbus_tx()
+ *
+ *  \param data pointer to the data
+ *  \param len  size of the data */
+void bsp_sysbus_tx_block(const uint8_t* data, uint32_t len);
+
+/** \brief   transmission of the data block via system bus is complete
+ *  \details this function is implemented in the library, call it when the
+ *           block given to bsp_sysbus_tx_block() is transmitted */
+void bsp_sysbus_tx_done_cb();
+
 /** \brief   receive data from system bus
  *  \details generally external system bus is a network with circle loop,
  *           this is input from previous device
  *           this function is implemented in the library, call it when
- *           byte is received. you can call it in the receive interrupt but be
- *           careful, this function may perform a lot of hard work: it parse
- *           the input stream and as it found correct message it start to
- *           seek the destination node and if it was not found retranslate
- *           message to next device in chain
+ *           byte is received. it's safe to call it in the receive interrupt:
+ *           it only parses the input stream and puts complete messages to
+ *           the queue. seeking of the destination node and retranslation to
+ *           the next device in chain are performed later by the system bus
+ *           kernel module
  *
  *  \param byte received byte */
 void bsp_sysbus_rx_cb(uint8_t byte);
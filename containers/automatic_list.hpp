@@ -10,7 +10,7 @@ class automatic_list
     automatic_list() : next(nullptr)
     { if (!root) { root = (TYPE*)this; }
 
-      if (last)  { last->next = (TYPE*)this; }
+      if (last)  { last->automatic_list<TYPE>::next = (TYPE*)this; }
 
       last = (TYPE*)this; }
 
@@ -152,6 +152,50 @@ class circular_buffer
       bsp_leave_critical();
       return true; }
 
+    /** \brief   deletes several values from the tail of the buffer
+     *  \details same as pop_tail() called count times, but in one step
+     *
+     *  \param count number of the values to delete
+     *
+     *  \return number of deleted values */
+    uint32_t pop_tail(uint32_t count)
+    { bsp_enter_critical();
+
+      if (count > fullness) { count = fullness; }
+
+      fullness -= count;
+      tail += count;
+
+      if (tail >= VOLUME) { tail -= VOLUME; }
+
+      bsp_leave_critical();
+      return count; }
+
+    /** \brief   contiguous piece of the stored values
+     *  \details values go in order of fetch_tail(), the piece ends at the end
+     *           of the stored values or at the end of the memory, so all of
+     *           the values are covered by two pieces at most
+     *
+     *  \param offset number of the values from the tail to skip
+     *  \param len    pointer to store number of the values in the piece
+     *
+     *  \return pointer to the first value of the piece
+     *  \retval nullptr no values at the offset */
+    TYPE* segment(uint32_t offset, uint32_t* len)
+    { if (offset >= fullness)
+      { *len = 0;
+        return nullptr; }
+
+      uint32_t start = tail + offset;
+
+      if (start >= VOLUME) { start -= VOLUME; }
+
+      *len = fullness - offset;
+
+      if (*len > VOLUME - start) { *len = VOLUME - start; }
+
+      return &memory[start]; }
+
     /** \brief returns memory volume that is already used
      *
      *  \return number of elements */
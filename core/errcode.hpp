@@ -33,6 +33,18 @@
 
 /** \brief trying to access area that not belong to buffer */
 #define ERR_BUFFER_OVERRUN 6
+
+/** \brief queue is full, try again later */
+#define ERR_BUSY 7
+
+/** \brief there is no answer in time */
+#define ERR_TIMEOUT 8
+
+/** \brief destination is known to be unreachable */
+#define ERR_UNREACHABLE 9
+
+/** \brief value doesn't fit the type */
+#define ERR_OUT_OF_RANGE 10
 /** \} */
 
 #endif // ERRCODE_HPP
@@ -7,7 +7,7 @@
 #include "containers/automatic_list.hpp"
 #include "core/module.hpp"
 
-class init_dependency : virtual public automatic_list<init_dependency>
+class init_dependency : public automatic_list<init_dependency>
 { public:
     init_dependency(i_kernel_module& source, i_kernel_module& target)
       : source(source), target(target) {}
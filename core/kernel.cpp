@@ -3,9 +3,9 @@
 
 #include <cstdint>
 #include "containers/automatic_list.hpp"
-#include "kernel/kernel.h"
-#include "kernel/module.hpp"
-#include "kernel/init.hpp"
+#include "core/kernel.h"
+#include "core/module.hpp"
+#include "core/init.hpp"
 
 void kernel_step(uint32_t ticks)
 { static bool greeting = false;
@@ -8,8 +8,8 @@
 #include "containers/automatic_list.hpp"
 #include "containers/linked_list.hpp"
 
-class i_kernel_module : public virtual automatic_list<i_kernel_module>,
-  public virtual linked_list<i_kernel_module>
+class i_kernel_module : public automatic_list<i_kernel_module>,
+  public linked_list<i_kernel_module>
 { public:
     /** \brief   this method will be periodically called with specified period
      *           to set up the module
@@ -101,7 +101,7 @@ class pipe : public i_pipe
     /** \brief get used data size
      *
      *  \return used data size */
-    virtual uint32_t fullness() override { return buf.fullness; }
+    virtual uint32_t fullness() override { return buf.memory_used(); }
 
     /** \brief get total size
      *
@@ -1,113 +1,619 @@
 /** \file  sysbus.cpp
- *  \brief system bus implementation
- *  \todo unfinished because the data serializer isn't finished too */
+ *  \brief system bus implementation */
 
 #include <cstdint>
+#include <cstring>
 #include "bsp/bsp.h"
-#include "containers/arrayed_buffer.hpp"
 #include "containers/automatic_list.hpp"
 #include "core/sysbus.hpp"
 #include "tools/serializer.hpp"
+#include "tools/crc.hpp"
 #include "core/errcode.hpp"
 
-/** \brief maximum length of the message */
-#define MESSAGE_SIZE 19
+sysbus system_bus;
 
-/** \brief   transmit function for the system bus
- *  \details adapter for bsp function
+sysbus_parser::sysbus_parser() : errors(0), used(0), sync(false) { }
+
+void sysbus_parser::reset() { used = 0; sync = false; }
+
+uint8_t sysbus_parser::end(uint8_t start)
+{ uint8_t size = (window[start + 2] & 0xF0) >> 4;
+  return start + SYSBUS_HEADER_SIZE + size + SYSBUS_CSUM_SIZE; }
+
+void sysbus_parser::drop()
+{ memmove(window, window + 1, used - 1);
+  memmove(sums, sums + 1, (used - 1) * sizeof(sums[0]));
+  used--; }
+
+bool sysbus_parser::take(uint8_t start)
+{ uint8_t* candidate = &window[start];
+  uint8_t size = (candidate[2] & 0xF0) >> 4;
+  deserializer in(candidate, SYSBUS_HEADER_SIZE + size);
+  uint8_t flags = 0;
+  in.v<uint8_t>(frame.dst).v<uint8_t>(frame.src).v<uint8_t>(flags)
+  .a(frame.data, size);
+  frame.size = size;
+  frame.ttl = flags & 0x0F;
+  frame.fragment = size == SYSBUS_FRAGMENT_SIZE;
+  used = 0;
+  sync = true;
+  return true; }
+
+bool sysbus_parser::check(uint8_t start, uint8_t byte)
+{ uint8_t sum = sums[start].get();
+
+  if (sum == byte) { return take(start); }
+
+  return false; }
+
+bool sysbus_parser::put(uint8_t byte)
+{ if (used >= SYSBUS_FRAME_SIZE) { drop(); }
+
+  window[used] = byte;
+  used++;
+
+  if (sync)
+  { if (used == 1) { sums[0].reset(); }
+
+    if (used <= SYSBUS_HEADER_SIZE || used < end(0))
+    { sums[0].put(byte);
+      return false; }
+
+    if (check(0, byte)) { return true; }
+
+    // frame is broken, look for the next one inside the window
+    errors++;
+    sync = false;
+    drop();
+
+    for (uint8_t start = 0; start + 1 < used; start++)
+    { sums[start].reset().put(&window[start], used - 1 - start); } }
+
+  // any byte in the window may be the start of the frame that ends here,
+  // checksum of every candidate is already calculated except this byte
+  for (uint8_t start = 0; start + 1 < used; start++)
+  { if (start + SYSBUS_HEADER_SIZE < used
+        && end(start) == used
+        && check(start, byte))
+    { return true; }
+
+    sums[start].put(byte); }
+
+  sums[used - 1].reset().put(byte);
+  return false; }
+
+/** \brief packs the frame into the stream
+ *
+ *  \param frame frame to pack
+ *  \param out   buffer for the packed frame, at least SYSBUS_FRAME_SIZE
  *
- *  \param arg  not used
- *  \param byte byte to send on a system bus */
-static void sysbus_tx(void* arg, uint8_t byte) { bsp_sysbus_tx(byte); }
+ *  \return size of the packed frame */
+static uint32_t encode(sysbus_frame& frame, uint8_t* out)
+{ serializer stream(out, SYSBUS_FRAME_SIZE);
+  uint8_t flags = ((frame.size << 4) & 0xF0) | (frame.ttl & 0x0F);
+  stream.v<uint8_t>(frame.dst).v<uint8_t>(frame.src).v<uint8_t>(flags)
+  .a(frame.data, frame.size);
+  stream.v<uint8_t>(sysbus_csum::calc(out, stream.pos));
+  return stream.pos; }
+
+/** \brief size of the message data in the first fragment */
+#define FRAGMENT_FIRST (SYSBUS_PAYLOAD_SIZE - 2)
+
+/** \brief size of the message data in the other fragments */
+#define FRAGMENT_NEXT (SYSBUS_PAYLOAD_SIZE - 1)
+
+static_assert(SYSBUS_MESSAGE_SIZE <= FRAGMENT_FIRST + 15 * FRAGMENT_NEXT,
+              "message doesn't fit in 16 fragments");
 
-/** \brief significator for system bus protocol
+/** \brief number of fragments of the message
  *
- *  \param arg   not used
- *  \param start start of the message to sign
- *  \param len   length of the message */
-bool sysbus_sign(void* arg, void* start, uint32_t len) { return true; }
+ *  \param size size of the message
+ *
+ *  \return number of fragments */
+static uint8_t fragments(uint8_t size)
+{ if (size <= FRAGMENT_FIRST) { return 1; }
+
+  return 1 + (size - FRAGMENT_FIRST + FRAGMENT_NEXT - 1) / FRAGMENT_NEXT; }
+
+sysbus::sysbus()
+  : ring(0), ring_updated(0), sent_next(0), ring_candidate(0), ring_returns(0),
+    tx_busy(false), fragment_id(0)
+{ for (uint8_t prio = 0; prio < SYSBUS_PRIORITIES; prio++)
+  { limit[prio] = SYSBUS_TX_QUEUE;
+    weight[prio] = 0;
+    credit[prio] = 0; }
+
+  name = "sysbus";
+  version = "0.1";
+  type = "core";
+  period = 0;
+  polled = 0;
+  ready = false; }
+
+void sysbus::init() { ready = true; }
+
+void sysbus::poll()
+{ for (sysbus_reassembly& slot : slots)
+  { if (slot.busy && polled - slot.started >= SYSBUS_REASSEMBLY_TIMEOUT)
+    { slot.busy = false;
+      stats.incomplete++; } }
+
+  if (ring && polled - ring_updated >= SYSBUS_ROUTE_TIMEOUT) { ring = 0; }
+
+  for (sysbus_route& r : routes)
+  { if (r.used && polled - r.updated >= SYSBUS_ROUTE_TIMEOUT)
+    { r.used = false; } }
+
+  i_sysbus_node* node = automatic_list<i_sysbus_node>::root;
+
+  while (node)
+  { if (node->bus == this) { node->tick(polled); }
+
+    node = node->next; }
+
+  sysbus_frame* frame = rx_queue.fetch_tail();
+
+  while (frame)
+  { receive(*frame);
+    rx_queue.pop_tail();
+    frame = rx_queue.fetch_tail(); }
+
+  transmit(); }
+
+void sysbus::rx(uint8_t byte)
+{ if (!parser.put(byte)) { return; }
+
+  stats.received++;
+
+  if (!rx_queue.push_head(parser.frame)) { stats.overflows++; } }
+
+sysbus_route* sysbus::route(uint8_t addr)
+{ for (sysbus_route& r : routes)
+  { if (r.used && r.addr == addr) { return &r; } }
+
+  return nullptr; }
+
+sysbus_route& sysbus::remember(uint8_t addr)
+{ sysbus_route* r = route(addr);
+
+  if (r) { return *r; }
 
-/** \brief retranslate message to external bus
+  r = &routes[0];
+
+  for (sysbus_route& candidate : routes)
+  { if (!candidate.used) { r = &candidate; break; }
+
+    if (polled - candidate.updated > polled - r->updated) { r = &candidate; } }
+
+  r->used = true;
+  r->addr = addr;
+  r->hops = SYSBUS_TTL_MAX;
+  r->reachable = true;
+  r->returns = 0;
+  r->updated = polled;
+  return *r; }
+
+void sysbus::forget()
+{ ring = 0;
+  ring_candidate = 0;
+  ring_returns = 0;
+
+  for (sysbus_route& r : routes) { r.used = false; }
+
+  for (sysbus_sent& s : sent) { s.used = false; } }
+
+/** \brief checksum of the frame without ttl, which changes on the way
  *
- *  \param data pointer to the data that should be sent
- *  \param size size of the data that should be sent
- *  \param src  source node on the bus
- *  \param dst  destination node on the bus
- *  \param ttl  time to live of the message */
-static void retranslate(uint8_t* data,
-                        uint8_t size,
-                        uint8_t src,
-                        uint8_t dst,
-                        uint8_t ttl)
-{ }
-// TODO: use commented text to lookup after serializer and deserializer would
-//       be finished. delete at all after that
-// { if (!data) { return; }
-//
-//   if (size > 15) { return; }
-//
-//   uint8_t tx_mess[MESSAGE_SIZE];
-//   serializer send_stream(tx_mess, sizeof(tx_mess));
-//   uint8_t flags =  ((size << 4) & 0xF0)
-//                    | ( ttl        & 0x0F);
-//   send_stream
-//   .u8(dst).u8(src).u8(flags).a(data, size).sign().tx(); }
-
-/** \brief   sends message
- *  \details firt loopback would be shanned for recepients and if there
- *           is no any recepient it would be sent to the bus
+ *  \param frame frame to check
  *
- *  \param data pointer to the data that should be sent
- *  \param size size of the data that should be sent
- *  \param src  source node on the bus
- *  \param dst  destination node on the bus
- *  \param ttl  time to live of the message */
-static void send_signal(uint8_t* data,
-                        uint8_t size,
-                        uint8_t src,
-                        uint8_t dst,
-                        uint8_t ttl)
-{ if (!data) { return; }
-
-  if (size > 15) { return; }
-
-  if (!ttl) { return; }
+ *  \return checksum */
+static uint8_t tag(sysbus_frame& frame)
+{ return sysbus_csum().put(frame.dst).put(frame.src).put(frame.size)
+         .put(frame.data, frame.size).get(); }
+
+void sysbus::track(sysbus_frame& frame)
+{ sysbus_sent& s = sent[sent_next];
+  sent_next = (sent_next + 1) % SYSBUS_SENT;
+  s.used = true;
+  s.dst = frame.dst;
+  s.tag = tag(frame);
+  s.ttl = frame.ttl; }
+
+uint8_t sysbus::farthest()
+{ uint8_t hops = 0;
+
+  // routes learned only from own returns have no distance
+  for (sysbus_route& r : routes)
+  { if (r.used && r.reachable && !r.returns && r.hops > hops)
+    { hops = r.hops; } }
+
+  return hops; }
+
+void sysbus::returned(sysbus_frame& frame)
+{ uint8_t t = tag(frame);
+  sysbus_sent* s = nullptr;
+
+  for (sysbus_sent& candidate : sent)
+  { if (candidate.used && candidate.dst == frame.dst && candidate.tag == t
+        && candidate.ttl >= frame.ttl)
+    { s = &candidate; break; } }
+
+  // noise that passed the checksum or the frame that is too old
+  if (!s) { return; }
+
+  s->used = false;
+  // every other device of the ring takes one from ttl, so it's the upper
+  // bound even if some of them cut ttl down to their own ring
+  uint8_t hops = s->ttl - frame.ttl + 1;
+
+  if (hops == ring_candidate) { ring_returns++; }
+  else
+  { ring_candidate = hops;
+    ring_returns = 1; }
+
+  if (ring_returns >= SYSBUS_RETURNS)
+  { // the ring is longer than the distance to any live address
+    uint8_t live = farthest();
+
+    if (hops <= live) { hops = live + 1; }
+
+    if (!ring || hops < ring) { ring = hops; }
+
+    ring_updated = polled; }
+
+  if (frame.dst >= SYSBUS_GROUP_FIRST) { return; }
 
+  sysbus_route& r = remember(frame.dst);
+
+  if (r.returns < SYSBUS_RETURNS) { r.returns++; }
+
+  if (r.returns >= SYSBUS_RETURNS) { r.reachable = false; }
+
+  r.updated = polled; }
+
+bool sysbus::learn(sysbus_frame& frame)
+{ // frame is sent with ttl no more than SYSBUS_TTL_MAX and loses one at
+  // every hop, so the distance is no more than this
+  uint8_t hops = SYSBUS_TTL_MAX - frame.ttl;
   i_sysbus_node* loopback = automatic_list<i_sysbus_node>::root;
 
   while (loopback)
-  { if (loopback->addr == dst)
-    { loopback->handler(data, size, src);
+  { // own frame went through the whole ring
+    if (loopback->bus == this && loopback->addr == frame.src)
+    { returned(frame);
+      return true; }
+
+    loopback = loopback->next; }
+
+  if (frame.src >= SYSBUS_GROUP_FIRST) { return false; }
+
+  sysbus_route& r = remember(frame.src);
+
+  if (!r.reachable || hops < r.hops) { r.hops = hops; }
+
+  r.reachable = true;
+  r.returns = 0;
+  r.updated = polled;
+
+  // frame came from farther than the learned ring
+  if (ring && r.hops >= ring) { ring = r.hops + 1; }
+
+  return false; }
+
+void sysbus::receive(sysbus_frame& frame)
+{ if (learn(frame)) { return; }
+
+  bool group = frame.dst >= SYSBUS_GROUP_FIRST;
+  bool consumed = false;
+
+  if (!frame.fragment)
+  { consumed = deliver(frame.data, frame.size, frame.src, frame.dst); }
+  else if (local(frame.dst))
+  { // fragments go further as is, group fragments are also reassembled on
+    // every device on their way
+    reassemble(frame);
+    consumed = !group; }
+
+  if (consumed) { return; }
+
+  if (!frame.ttl) { stats.expired++; return; }
+
+  sysbus_route* r = route(frame.dst);
+
+  if (r && !r->reachable) { stats.unreachable++; return; }
+
+  if (ring && frame.ttl > ring) { frame.ttl = ring; }
+
+  frame.ttl--;
+
+  if (queue(frame, SYSBUS_PRIORITY_FORWARD) == ERR_OK)
+  { stats.retranslated++; }
+
+  transmit(); }
+
+bool sysbus::local(uint8_t dst)
+{ i_sysbus_node* loopback = automatic_list<i_sysbus_node>::root;
+
+  while (loopback)
+  { if (loopback->bus == this && loopback->accepts(dst)) { return true; }
+
+    loopback = loopback->next; }
+
+  return false; }
+
+void sysbus::reassemble(sysbus_frame& frame)
+{ if (!frame.size) { return; }
+
+  uint8_t id = frame.data[0] >> 4;
+  uint8_t index = frame.data[0] & 0x0F;
+  sysbus_reassembly* slot = nullptr;
+
+  for (sysbus_reassembly& s : slots)
+  { if (s.busy && s.src == frame.src && s.dst == frame.dst && s.id == id)
+    { slot = &s; break; } }
+
+  for (sysbus_reassembly& s : slots)
+  { if (slot) { break; }
+
+    // message from the same source with another id is abandoned
+    if (!s.busy || (s.src == frame.src && s.dst == frame.dst)) { slot = &s; } }
+
+  if (!slot) { return; }
+
+  if (!slot->busy || slot->id != id)
+  { slot->busy = true;
+    slot->src = frame.src;
+    slot->dst = frame.dst;
+    slot->id = id;
+    slot->size = 0;
+    slot->count = 0;
+    slot->received = 0;
+    slot->started = polled; }
+
+  uint8_t* chunk = &frame.data[1];
+  uint8_t len = frame.size - 1;
+  uint32_t offset = FRAGMENT_FIRST + (index - 1) * FRAGMENT_NEXT;
+
+  if (!index)
+  { if (frame.size < 2 || frame.data[1] > SYSBUS_MESSAGE_SIZE)
+    { slot->busy = false;
       return; }
 
+    slot->size = frame.data[1];
+    slot->count = fragments(slot->size);
+    chunk++;
+    len--;
+    offset = 0; }
+
+  if (offset >= SYSBUS_MESSAGE_SIZE)
+  { slot->busy = false;
+    return; }
+
+  // the last fragment is padded up to the full payload
+  if (offset + len > SYSBUS_MESSAGE_SIZE)
+  { len = SYSBUS_MESSAGE_SIZE - offset; }
+
+  memcpy(&slot->data[offset], chunk, len);
+  slot->received |= (uint16_t)(1 << index);
+
+  if (!slot->count || slot->received != (uint16_t)((1 << slot->count) - 1))
+  { return; }
+
+  slot->busy = false;
+  deliver(slot->data, slot->size, slot->src, slot->dst); }
+
+void sysbus::tx_done() { tx_busy = false; }
+
+void sysbus::transmit()
+{ if (tx_busy) { return; }
+
+  uint32_t len = 0;
+
+  while (len + SYSBUS_FRAME_SIZE <= sizeof(tx_block))
+  { uint8_t prio = pick();
+
+    if (prio >= SYSBUS_PRIORITIES) { break; }
+
+    len += encode(*tx_queue[prio].fetch_tail(), &tx_block[len]);
+    tx_queue[prio].pop_tail();
+    stats.transmitted++; }
+
+  if (!len) { return; }
+
+  tx_busy = true;
+  tx(tx_block, len); }
+
+void sysbus::tx(const uint8_t* data, uint32_t len)
+{ bsp_sysbus_tx_block(data, len); }
+
+uint8_t sysbus::pick()
+{ for (uint8_t round = 0; round < 2; round++)
+  { for (uint8_t prio = 0; prio < SYSBUS_PRIORITIES; prio++)
+    { if (!tx_queue[prio].memory_used()) { continue; }
+
+      if (!weight[prio]) { return prio; }
+
+      if (credit[prio]) { credit[prio]--; return prio; } }
+
+    // every waiting queue has spent its share, start the next round
+    for (uint8_t prio = 0; prio < SYSBUS_PRIORITIES; prio++)
+    { credit[prio] = weight[prio]; } }
+
+  return SYSBUS_PRIORITIES; }
+
+uint32_t sysbus::room(uint8_t prio) const
+{ uint32_t used = tx_queue[prio].memory_used();
+  uint32_t available = tx_queue[prio].memory_available();
+
+  if (used >= limit[prio]) { return 0; }
+
+  return (limit[prio] - used < available) ? limit[prio] - used : available; }
+
+uint8_t sysbus::queue(sysbus_frame& frame, uint8_t prio)
+{ if (prio >= SYSBUS_PRIORITIES) { prio = SYSBUS_PRIORITIES - 1; }
+
+  if (!room(prio) || !tx_queue[prio].push_head(frame))
+  { stats.overflows++;
+    return ERR_BUSY; }
+
+  return ERR_OK; }
+
+uint8_t sysbus::split(uint8_t* data,
+                      uint8_t size,
+                      uint8_t src,
+                      uint8_t dst,
+                      uint8_t ttl,
+                      uint8_t prio)
+{ if (size > SYSBUS_MESSAGE_SIZE)
+  { stats.oversized++;
+    return ERR_INVALID_ARGUMENT; }
+
+  if (prio >= SYSBUS_PRIORITIES) { prio = SYSBUS_PRIORITIES - 1; }
+
+  // partial message is useless, so all of the fragments or nothing
+  uint8_t count = fragments(size);
+
+  if (room(prio) < count)
+  { stats.overflows++;
+    return ERR_BUSY; }
+
+  uint8_t id = fragment_id++ & 0x0F;
+  uint8_t offset = 0;
+
+  for (uint8_t index = 0; index < count; index++)
+  { sysbus_frame frame;
+    frame.dst = dst;
+    frame.src = src;
+    frame.ttl = ttl;
+    frame.fragment = true;
+    serializer out(frame.data, sizeof(frame.data));
+    out.v<uint8_t>((uint8_t)(id << 4 | index));
+
+    if (!index) { out.v<uint8_t>(size); }
+
+    uint8_t len = sizeof(frame.data) - out.pos;
+
+    if (len > size - offset) { len = size - offset; }
+
+    out.a(&data[offset], len);
+    offset += len;
+    memset(&frame.data[out.pos], 0, sizeof(frame.data) - out.pos);
+    frame.size = SYSBUS_FRAGMENT_SIZE;
+
+    if (queue(frame, prio) == ERR_OK && !index) { track(frame); } }
+
+  return ERR_OK; }
+
+void sysbus::invoke(i_sysbus_node& node,
+                    uint8_t* data,
+                    uint8_t size,
+                    uint8_t src)
+{ uint32_t start = bsp_timestamp();
+  node.handler(data, size, src);
+  node.timing.add(bsp_timestamp() - start);
+  stats.delivered++; }
+
+bool sysbus::deliver(uint8_t* data, uint8_t size, uint8_t src, uint8_t dst)
+{ bool group = dst >= SYSBUS_GROUP_FIRST;
+  i_sysbus_node* loopback = automatic_list<i_sysbus_node>::root;
+
+  while (loopback)
+  { if (loopback->bus == this && loopback->accepts(dst))
+    { if (!group) { invoke(*loopback, data, size, src); return true; }
+
+      // sender of the group message doesn't receive it
+      if (loopback->addr != src) { invoke(*loopback, data, size, src); } }
+
     loopback = loopback->next; }
 
-  retranslate(data, size, src, dst, ttl - 1); }
+  return false; }
 
-/** \brief implementation of bsp sysbus callback
- *
- *  \param byte received byte */
-// TODO: use commented text to lookup after serializer and deserializer would
-//       be finished. delete at all after that
-// void bsp_sysbus_rx_cb(uint8_t byte)
-// { static uint8_t rx_message[MESSAGE_SIZE];
-//   static deserializer input_stream(rx_message, sizeof(rx_message));
-//   input_stream.put(&byte, 1);
-//
-//   if (input_stream.validate())
-//   { uint8_t src = 0;
-//     uint8_t dst = 0;
-//     uint8_t flags = 0;
-//     uint8_t* data = nullptr;
-//     input_stream.pos = 0;
-//     input_stream.u8(dst).u8(src).u8(flags);
-//     data = &rx_message[input_stream.pos];
-//     uint8_t size = (flags & 0xF0) >> 4;
-//     uint8_t ttl  =  flags & 0x0F      ;
-//     send_signal(data, size, src, dst, ttl); } }
-
-void i_sysbus_node::signal(uint8_t* data,
-                           uint8_t size,
-                           uint8_t dst,
-                           uint8_t ttl)
-{ send_signal(data, size, addr, dst, ttl); }
+uint8_t sysbus::send(uint8_t* data,
+                     uint8_t size,
+                     uint8_t src,
+                     uint8_t dst,
+                     uint8_t ttl,
+                     uint8_t prio)
+{ if (!data) { return ERR_INVALID_ARGUMENT; }
+
+  // local nodes get the message as is, whatever size it has
+  if (deliver(data, size, src, dst) || !ttl) { return ERR_OK; }
+
+  sysbus_route* r = route(dst);
+
+  if (r && !r->reachable)
+  { stats.unreachable++;
+    return ERR_UNREACHABLE; }
+
+  // frame needs no more hops than devices in the ring, the last one brings
+  // it back to the sender
+  if (ring && ttl > ring) { ttl = ring; }
+
+  uint8_t errcode = ERR_OK;
+
+  if (size >= SYSBUS_FRAGMENT_SIZE)
+  { errcode = split(data, size, src, dst, ttl - 1, prio); }
+  else
+  { sysbus_frame frame;
+    frame.dst = dst;
+    frame.src = src;
+    frame.size = size;
+    frame.ttl = ttl - 1;
+    frame.fragment = false;
+    memcpy(frame.data, data, size);
+    errcode = queue(frame, prio);
+
+    if (errcode == ERR_OK) { track(frame); } }
+
+  transmit();
+  return errcode; }
+
+sysbus_stats::sysbus_stats() { reset(); }
+
+void sysbus_stats::reset()
+{ received = 0;
+  delivered = 0;
+  retranslated = 0;
+  transmitted = 0;
+  expired = 0;
+  oversized = 0;
+  unreachable = 0;
+  overflows = 0;
+  incomplete = 0; }
+
+sysbus_histogram::sysbus_histogram() { reset(); }
+
+void sysbus_histogram::reset()
+{ memset(buckets, 0, sizeof(buckets));
+  calls = 0;
+  max = 0; }
+
+void sysbus_histogram::add(uint32_t time)
+{ // bucket n contains times from 2^(n-1) to 2^n - 1
+  uint32_t bucket = (time) ? 32 - __builtin_clz(time) : 0;
+
+  if (bucket >= SYSBUS_HISTOGRAM) { bucket = SYSBUS_HISTOGRAM - 1; }
+
+  buckets[bucket]++;
+  calls++;
+
+  if (time > max) { max = time; } }
+
+void bsp_sysbus_rx_cb(uint8_t byte) { system_bus.rx(byte); }
+
+void bsp_sysbus_tx_done_cb() { system_bus.tx_done(); }
+
+__attribute__((weak)) uint32_t bsp_timestamp() { return 0; }
+
+__attribute__((weak)) void bsp_sysbus_tx_block(const uint8_t* data,
+                                               uint32_t len)
+{ while (len) { bsp_sysbus_tx(*data); data++; len--; }
+
+  bsp_sysbus_tx_done_cb(); }
+
+uint8_t i_sysbus_node::signal(uint8_t* data,
+                              uint8_t size,
+                              uint8_t dst,
+                              uint8_t ttl,
+                              uint8_t prio)
+{ return bus->send(data, size, addr, dst, ttl, prio); }
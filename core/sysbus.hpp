@@ -6,12 +6,718 @@
 
 #include <cstdint>
 #include "containers/automatic_list.hpp"
+#include "containers/circular_buffer.hpp"
+#include "core/module.hpp"
+#include "tools/crc.hpp"
+
+/** \defgroup sysbus_config
+ *  \brief    system bus frame format and configuration
+ *  \{ */
+
+/** \brief size of the frame header: destination, source and flags */
+#define SYSBUS_HEADER_SIZE 3
+
+/** \brief maximum size of the payload of one frame */
+#define SYSBUS_PAYLOAD_SIZE 15
+
+/** \brief size of the frame checksum */
+#define SYSBUS_CSUM_SIZE 1
+
+/** \brief   checksum of the frame, it covers the header and the payload
+ *  \details CRC-8 with poly 0x07, nonzero initial value guarantees that
+ *           sequence of zeros is not a valid frame */
+typedef crc<uint8_t, 0x07, 0xFF, false, 0x00> sysbus_csum;
+
+/** \brief maximum length of the frame on the bus */
+#define SYSBUS_FRAME_SIZE \
+  (SYSBUS_HEADER_SIZE + SYSBUS_PAYLOAD_SIZE + SYSBUS_CSUM_SIZE)
+
+/** \brief   number of complete frames that can wait for the dispatching
+ *  \details redefine it in compiler flags if your bus is heavy loaded */
+#ifndef SYSBUS_RX_QUEUE
+  #define SYSBUS_RX_QUEUE 4
+#endif
+
+/** \brief   number of frames that can wait for the transmission in every
+ *           priority queue
+ *  \details redefine it in compiler flags if your bus is heavy loaded */
+#ifndef SYSBUS_TX_QUEUE
+  #define SYSBUS_TX_QUEUE 8
+#endif
+
+/** \brief   number of the transmission priorities
+ *  \details priority 0 is the highest one */
+#ifndef SYSBUS_PRIORITIES
+  #define SYSBUS_PRIORITIES 3
+#endif
+
+/** \brief priority of the urgent control messages */
+#define SYSBUS_PRIORITY_HIGH 0
+
+/** \brief default priority of the messages */
+#define SYSBUS_PRIORITY_NORMAL (SYSBUS_PRIORITIES / 2)
+
+/** \brief priority of the bulk data */
+#define SYSBUS_PRIORITY_LOW (SYSBUS_PRIORITIES - 1)
+
+/** \brief   priority of the retranslated frames
+ *  \details there is no priority in the frame, so frames from the ring are
+ *           forwarded with this one. frame that is already on the ring goes
+ *           first, so transit time is bounded and the load is limited at the
+ *           sources */
+#ifndef SYSBUS_PRIORITY_FORWARD
+  #define SYSBUS_PRIORITY_FORWARD SYSBUS_PRIORITY_HIGH
+#endif
+
+/** \brief   maximum size of the block that is given to the bsp at once
+ *  \details all of the waiting frames that fit in the block are sent by one
+ *           bsp_sysbus_tx_block() call */
+#ifndef SYSBUS_TX_BLOCK
+  #define SYSBUS_TX_BLOCK (SYSBUS_FRAME_SIZE * 4)
+#endif
+
+/** \brief   maximum size of the message
+ *  \details messages larger than payload of the frame are split in
+ *           fragments. redefine it in compiler flags, but no more than 223 */
+#ifndef SYSBUS_MESSAGE_SIZE
+  #define SYSBUS_MESSAGE_SIZE 64
+#endif
+
+/** \brief number of fragmented messages that can be reassembled at once */
+#ifndef SYSBUS_REASSEMBLY_SLOTS
+  #define SYSBUS_REASSEMBLY_SLOTS 2
+#endif
+
+/** \brief   time in ticks to wait for the missing fragments
+ *  \details incomplete message is dropped after that */
+#ifndef SYSBUS_REASSEMBLY_TIMEOUT
+  #define SYSBUS_REASSEMBLY_TIMEOUT 1000
+#endif
+
+/** \brief   size field of the fragment
+ *  \details fragment always carries the full payload, the last one is
+ *           padded with zeros, so the largest size marks the fragment and
+ *           single frame carries one byte less */
+#define SYSBUS_FRAGMENT_SIZE SYSBUS_PAYLOAD_SIZE
+
+/** \brief address of all of the nodes on the bus */
+#define SYSBUS_BROADCAST 0xFF
+
+/** \brief first address reserved for the multicast groups */
+#define SYSBUS_GROUP_FIRST 0xF0
+
+/** \brief number of the multicast groups */
+#define SYSBUS_GROUPS (SYSBUS_BROADCAST - SYSBUS_GROUP_FIRST)
+
+/** \brief   address of the multicast group
+ *
+ *  \param n number of the group, 0 .. SYSBUS_GROUPS - 1 */
+#define SYSBUS_GROUP(n) (SYSBUS_GROUP_FIRST + (n))
+
+/** \brief maximum time to live of the frame */
+#define SYSBUS_TTL_MAX 15
+
+/** \brief number of the addresses that the bus remembers */
+#ifndef SYSBUS_ROUTES
+  #define SYSBUS_ROUTES 16
+#endif
+
+/** \brief   time in ticks while the learned route is valid
+ *  \details after that the route is forgotten and learned again, so the
+ *           changes of the ring are noticed */
+#ifndef SYSBUS_ROUTE_TIMEOUT
+  #define SYSBUS_ROUTE_TIMEOUT 10000
+#endif
+
+/** \brief   number of the own frames that the bus remembers
+ *  \details only remembered frames that return from the ring are learned
+ *           from, anything else with own source is noise or too old */
+#ifndef SYSBUS_SENT
+  #define SYSBUS_SENT 4
+#endif
+
+/** \brief   number of the consistent returns of own frames to learn from
+ *  \details noise may pass the checksum, so one return proves nothing */
+#ifndef SYSBUS_RETURNS
+  #define SYSBUS_RETURNS 2
+#endif
+
+/** \brief   number of the buckets of the handler execution time histogram
+ *  \details bucket n counts the times from 2^(n-1) to 2^n - 1, the last one
+ *           counts all of the longer times */
+#ifndef SYSBUS_HISTOGRAM
+  #define SYSBUS_HISTOGRAM 16
+#endif
+
+/** \} */
+
+class i_sysbus_node;
+class print;
+
+/** \brief one frame of the system bus in unpacked form */
+class sysbus_frame
+{ public:
+    /** \brief destination node */
+    uint8_t dst;
+
+    /** \brief source node */
+    uint8_t src;
+
+    /** \brief size of the payload */
+    uint8_t size;
+
+    /** \brief time to live of the frame */
+    uint8_t ttl;
+
+    /** \brief payload of the frame */
+    uint8_t data[SYSBUS_PAYLOAD_SIZE];
+
+    /** \brief   the frame is the fragment of larger message
+     *  \details it has SYSBUS_FRAGMENT_SIZE in the size field. first byte of the fragment is its header: number of the
+     *           message in high nibble and number of the fragment in low
+     *           nibble. first fragment contains size of the message in the
+     *           next byte */
+    bool fragment; };
+
+/** \brief counters of the bus events */
+class sysbus_stats
+{ public:
+    sysbus_stats();
+
+    /** \brief set all of the counters to zero */
+    void reset();
+
+    /** \brief frames received from the bus */
+    uint32_t received;
+
+    /** \brief messages given to the local handlers */
+    uint32_t delivered;
+
+    /** \brief frames from the bus that are queued to the next device */
+    uint32_t retranslated;
+
+    /** \brief frames given to the bsp */
+    uint32_t transmitted;
+
+    /** \brief frames dropped because their ttl is zero */
+    uint32_t expired;
+
+    /** \brief messages dropped because they are larger than maximum size */
+    uint32_t oversized;
+
+    /** \brief messages dropped because their destination is unreachable */
+    uint32_t unreachable;
+
+    /** \brief frames dropped because the queue is full */
+    uint32_t overflows;
+
+    /** \brief fragmented messages that weren't reassembled in time */
+    uint32_t incomplete; };
+
+/** \brief   histogram of the handler execution time
+ *  \details time is measured by bsp_timestamp() */
+class sysbus_histogram
+{ public:
+    sysbus_histogram();
+
+    /** \brief clear the histogram */
+    void reset();
+
+    /** \brief count one execution
+     *
+     *  \param time execution time */
+    void add(uint32_t time);
+
+    /** \brief number of the executions in every bucket */
+    uint32_t buckets[SYSBUS_HISTOGRAM];
+
+    /** \brief total number of the executions */
+    uint32_t calls;
+
+    /** \brief longest execution time */
+    uint32_t max; };
+
+/** \brief what the bus knows about the remote address */
+class sysbus_route
+{ public:
+    sysbus_route() : used(false) {}
+
+    /** \brief record is used */
+    bool used;
+
+    /** \brief remote address */
+    uint8_t addr;
+
+    /** \brief   distance from the address to this device in hops
+     *  \details it's the upper bound, it's exact if the address sends frames
+     *           with SYSBUS_TTL_MAX */
+    uint8_t hops;
+
+    /** \brief   address is reachable
+     *  \details address is unreachable if SYSBUS_RETURNS messages to it went
+     *           through the whole ring */
+    bool reachable;
+
+    /** \brief   number of own messages to the address that returned
+     *  \details it's cleared by any frame from the address */
+    uint8_t returns;
+
+    /** \brief time of the last update */
+    uint32_t updated; };
+
+/** \brief own frame that may return from the ring */
+class sysbus_sent
+{ public:
+    sysbus_sent() : used(false) {}
+
+    /** \brief record is used */
+    bool used;
+
+    /** \brief destination of the frame */
+    uint8_t dst;
+
+    /** \brief checksum of the frame without ttl */
+    uint8_t tag;
+
+    /** \brief time to live of the frame as it was sent */
+    uint8_t ttl; };
+
+/** \brief message that is being reassembled from the fragments */
+class sysbus_reassembly
+{ public:
+    sysbus_reassembly() : busy(false) {}
+
+    /** \brief slot is used */
+    bool busy;
+
+    /** \brief source node of the message */
+    uint8_t src;
+
+    /** \brief destination of the message */
+    uint8_t dst;
+
+    /** \brief number of the message */
+    uint8_t id;
+
+    /** \brief size of the message */
+    uint8_t size;
+
+    /** \brief number of the fragments, zero until the first one arrived */
+    uint8_t count;
+
+    /** \brief bit n is set when fragment n is received */
+    uint16_t received;
+
+    /** \brief time of the first received fragment */
+    uint32_t started;
+
+    /** \brief data of the message */
+    uint8_t data[SYSBUS_MESSAGE_SIZE]; };
+
+/** \brief   incremental parser of the system bus input stream
+ *  \details takes the stream byte by byte. there is no preamble in the frame,
+ *           so while the parser is synchronized it expects the next frame
+ *           right after the previous one and checks it only once, as the
+ *           header tells that it's complete. if the check fails the parser
+ *           keeps the window of the last received bytes and checks every
+ *           position of the window that may be the start of the frame
+ *           ending with the received byte, so it catches the next frame
+ *           right after any corrupted or lost byte. checksum of every
+ *           candidate is updated incrementally, so work per byte is limited
+ *           by the frame size and doesn't depend on the bus load */
+class sysbus_parser
+{ public:
+    sysbus_parser();
+
+    /** \brief put received byte to the parser
+     *
+     *  \param byte received byte
+     *
+     *  \return result of parsing
+     *  \retval true  valid frame is recognized, see frame field
+     *  \retval false frame is not complete yet */
+    bool put(uint8_t byte);
+
+    /** \brief drop all of the received data */
+    void reset();
+
+    /** \brief last recognized frame */
+    sysbus_frame frame;
+
+    /** \brief   number of the frames with wrong checksum
+     *  \details only frames at the expected position are counted, garbage
+     *           between the frames isn't an error */
+    uint32_t errors;
+
+  private:
+    /** \brief window of the last received bytes */
+    uint8_t window[SYSBUS_FRAME_SIZE];
+
+    /** \brief   checksums of the window
+     *  \details every element is the checksum from the same position of the
+     *           window to its end */
+    sysbus_csum sums[SYSBUS_FRAME_SIZE];
+
+    /** \brief number of bytes inside the window */
+    uint8_t used;
+
+    /** \brief   parser is synchronized with the stream
+     *  \details the window starts with the first byte of the frame */
+    bool sync;
+
+    /** \brief end of the candidate frame according its header
+     *
+     *  \param start position of the candidate in the window
+     *
+     *  \return position after the last byte of the candidate */
+    uint8_t end(uint8_t start);
+
+    /** \brief drop the first byte of the window */
+    void drop();
+
+    /** \brief   unpack the candidate to the frame field
+     *  \details the window is cleared after that
+     *
+     *  \param start position of the candidate in the window
+     *
+     *  \return always true */
+    bool take(uint8_t start);
+
+    /** \brief check the candidate that ends with received byte
+     *
+     *  \param start position of the candidate in the window
+     *  \param byte  received byte, checksum of the candidate
+     *
+     *  \return result of check
+     *  \retval true  candidate is the valid frame, it's unpacked
+     *  \retval false candidate is not valid */
+    bool check(uint8_t start, uint8_t byte); };
+
+/** \brief   system bus service
+ *  \details receive path is split in two parts. bsp_sysbus_rx_cb() puts bytes
+ *           to the parser and complete frames to the queue, it's safe to call
+ *           it in the interrupt. dispatching to the nodes and retransmission
+ *           of the frames are done in the poll() by the kernel
+ *  \details outgoing frames are queued and sent by blocks, one block
+ *           contains as many frames as it can. next block is started after
+ *           the bsp reports that previous one is transmitted
+ *  \details every priority has its own queue. by default higher priority
+ *           queue is always emptied first. set weight of the queues to
+ *           share the bus: queue with nonzero weight sends no more than
+ *           weight frames while other queues have something to send
+ *  \details bus learns the ring from the frames it receives. own frame that
+ *           returns from the ring gives the size of the ring, time to live
+ *           of all of the frames is limited by it. unicast frame that returns
+ *           means that its destination is unreachable, messages to it are
+ *           dropped until the route is forgotten. frames from the remote
+ *           address give the distance to it
+ *  \details only the last SYSBUS_SENT own frames are recognized when they
+ *           return, and SYSBUS_RETURNS consistent returns are needed to
+ *           learn, so noise that passes the checksum doesn't shrink the ring.
+ *           the ring is never shorter than the distance to live address
+ *  \details device has one bus, system_bus. you can create more buses and
+ *           connect them to something else than bsp by overriding of tx(),
+ *           for example to simulate several devices in one process */
+class sysbus : public i_kernel_module
+{ public:
+    sysbus();
+
+    virtual void init() override;
+
+    virtual void poll() override;
+
+    /** \brief   receive side of the bus
+     *  \details called from bsp_sysbus_rx_cb()
+     *
+     *  \param byte received byte */
+    void rx(uint8_t byte);
+
+    /** \brief   transmission of the block is complete
+     *  \details called from bsp_sysbus_tx_done_cb() */
+    void tx_done();
+
+    /** \brief   start transmission of the block
+     *  \details gives the block to bsp_sysbus_tx_block(), tx_done() should
+     *           be called when the block is transmitted
+     *
+     *  \param data pointer to the block
+     *  \param len  size of the block */
+    virtual void tx(const uint8_t* data, uint32_t len);
+
+    /** \brief   sends message
+     *  \details first loopback would be scanned for recepients and if there
+     *           is no any recepient it would be sent to the bus
+     *  \details message to the group or broadcast is delivered to all of
+     *           the local members in one pass and always sent to the bus
+     *           once, every device on the ring do the same. the message is
+     *           dropped when it returns to the device of the sender
+     *  \details message with zero ttl is not sent to the bus
+     *  \details message of SYSBUS_FRAGMENT_SIZE bytes or more is delivered
+     *           to the local nodes as is and sent to the bus by fragments,
+     *           up to SYSBUS_MESSAGE_SIZE. receiving device reassembles it
+     *           and handler gets the whole message
+     *
+     *  \param data pointer to the data that should be sent
+     *  \param size size of the data that should be sent
+     *  \param src  source node on the bus
+     *  \param dst  destination node on the bus
+     *  \param ttl  time to live of the message
+     *  \param prio priority of the transmission
+     *
+     *  \return error code
+     *  \retval ERR_OK               message is delivered or queued
+     *  \retval ERR_INVALID_ARGUMENT message is empty or too large
+     *  \retval ERR_BUSY             transmission queue is full, message isn't
+     *                               sent to the bus
+     *  \retval ERR_UNREACHABLE      destination is known to be unreachable */
+    uint8_t send(uint8_t* data,
+                 uint8_t size,
+                 uint8_t src,
+                 uint8_t dst,
+                 uint8_t ttl,
+                 uint8_t prio = SYSBUS_PRIORITY_NORMAL);
+
+    /** \brief parser of the input stream */
+    sysbus_parser parser;
+
+    /** \brief frames that wait for the dispatching */
+    circular_buffer_static<sysbus_frame, SYSBUS_RX_QUEUE> rx_queue;
+
+    /** \brief frames that wait for the transmission, one queue per priority */
+    circular_buffer_static<sysbus_frame, SYSBUS_TX_QUEUE>
+    tx_queue[SYSBUS_PRIORITIES];
+
+    /** \brief   maximum number of frames in the queue
+     *  \details no more than SYSBUS_TX_QUEUE */
+    uint8_t limit[SYSBUS_PRIORITIES];
+
+    /** \brief   number of frames that the queue sends per round
+     *  \details zero means that the queue is served while it's not empty */
+    uint8_t weight[SYSBUS_PRIORITIES];
+
+    /** \brief messages that are being reassembled */
+    sysbus_reassembly slots[SYSBUS_REASSEMBLY_SLOTS];
+
+    /** \brief learned remote addresses */
+    sysbus_route routes[SYSBUS_ROUTES];
+
+    /** \brief   number of the devices in the ring, zero if unknown
+     *  \details it's the upper bound, it's exact if the own frame with
+     *           SYSBUS_TTL_MAX returned */
+    uint8_t ring;
+
+    /** \brief time of the last update of the ring size */
+    uint32_t ring_updated;
+
+    /** \brief last own frames that may return from the ring */
+    sysbus_sent sent[SYSBUS_SENT];
+
+    /** \brief record of sent for the next own frame */
+    uint8_t sent_next;
+
+    /** \brief size of the ring given by the last returned own frame */
+    uint8_t ring_candidate;
+
+    /** \brief number of the returns that gave ring_candidate in a row */
+    uint8_t ring_returns;
+
+    /** \brief find the learned route
+     *
+     *  \param addr remote address
+     *
+     *  \return pointer to the route or null if address is unknown */
+    sysbus_route* route(uint8_t addr);
+
+    /** \brief forget everything learned about the ring */
+    void forget();
+
+    /** \brief   print the counters and the histograms of the local nodes
+     *  \details implemented in sysbus_report.cpp, so the bus doesn't depend
+     *           on print until it's used
+     *
+     *  \param out output */
+    void report(print& out);
+
+    /** \brief counters of the bus events, see also parser.errors */
+    sysbus_stats stats;
+
+  private:
+    /** \brief handle frame received from the bus
+     *
+     *  \param frame received frame */
+    void receive(sysbus_frame& frame);
+
+    /** \brief learn the ring from the received frame
+     *
+     *  \param frame received frame
+     *
+     *  \return result of learning
+     *  \retval true  frame went through the whole ring, drop it
+     *  \retval false frame should be handled */
+    bool learn(sysbus_frame& frame);
+
+    /** \brief   learn from own frame that returned from the ring
+     *  \details frame that wasn't sent by this device is ignored
+     *
+     *  \param frame received frame */
+    void returned(sysbus_frame& frame);
+
+    /** \brief remember own frame, so its return is recognized
+     *
+     *  \param frame frame that is queued */
+    void track(sysbus_frame& frame);
+
+    /** \brief distance to the farthest live address
+     *
+     *  \return distance in hops */
+    uint8_t farthest();
+
+    /** \brief   remember the remote address
+     *  \details oldest record is replaced if there is no free one
+     *
+     *  \param addr remote address
+     *
+     *  \return reference to the route */
+    sysbus_route& remember(uint8_t addr);
+
+    /** \brief deliver message to the local nodes
+     *
+     *  \param data pointer to the message
+     *  \param size size of the message
+     *  \param src  source node
+     *  \param dst  destination node or group
+     *
+     *  \return result of delivery
+     *  \retval true  the message is consumed by the destination node
+     *  \retval false the message should go further */
+    bool deliver(uint8_t* data, uint8_t size, uint8_t src, uint8_t dst);
+
+    /** \brief call the handler of the node and measure its execution time
+     *
+     *  \param node destination node
+     *  \param data pointer to the message
+     *  \param size size of the message
+     *  \param src  source node */
+    void invoke(i_sysbus_node& node, uint8_t* data, uint8_t size, uint8_t src);
+
+    /** \brief check that there is a local recepient for the address
+     *
+     *  \param dst destination node or group
+     *
+     *  \return true if any local node accepts the address */
+    bool local(uint8_t dst);
+
+    /** \brief put the fragment to its message, deliver complete message
+     *
+     *  \param frame received fragment */
+    void reassemble(sysbus_frame& frame);
+
+    /** \brief split the message in fragments and queue them
+     *
+     *  \param data pointer to the message
+     *  \param size size of the message
+     *  \param src  source node
+     *  \param dst  destination node or group
+     *  \param ttl  time to live of the fragments
+     *  \param prio priority of the transmission
+     *
+     *  \return error code, see send() */
+    uint8_t split(uint8_t* data,
+                  uint8_t size,
+                  uint8_t src,
+                  uint8_t dst,
+                  uint8_t ttl,
+                  uint8_t prio);
+
+    /** \brief number of frames that can be queued with the priority
+     *
+     *  \param prio priority of the transmission
+     *
+     *  \return number of frames */
+    uint32_t room(uint8_t prio) const;
+
+    /** \brief queue the frame for the transmission
+     *
+     *  \param frame frame to send
+     *  \param prio  priority of the transmission
+     *
+     *  \return error code
+     *  \retval ERR_OK   frame is queued
+     *  \retval ERR_BUSY queue is full */
+    uint8_t queue(sysbus_frame& frame, uint8_t prio);
+
+    /** \brief choose the queue of the next frame to transmit
+     *
+     *  \return priority of the queue, SYSBUS_PRIORITIES if all are empty */
+    uint8_t pick();
+
+    /** \brief   start transmission of the waiting frames
+     *  \details does nothing while previous block is not transmitted */
+    void transmit();
+
+    /** \brief block that is being transmitted */
+    uint8_t tx_block[SYSBUS_TX_BLOCK];
+
+    /** \brief the block is given to the bsp and not transmitted yet */
+    volatile bool tx_busy;
+
+    /** \brief number of the next fragmented message */
+    uint8_t fragment_id;
+
+    /** \brief frames that the queue can send in the current round */
+    uint8_t credit[SYSBUS_PRIORITIES]; };
+
+/** \brief system bus of the device */
+extern sysbus system_bus;
 
 class i_sysbus_node : public automatic_list<i_sysbus_node>
 { public:
-    /** \brief address of the current node */
+    /** \brief constructor
+     *
+     *  \param bus bus which the node is connected to */
+    explicit i_sysbus_node(sysbus& bus = system_bus) : groups(0), bus(&bus) {}
+
+    /** \brief   address of the current node
+     *  \details addresses from SYSBUS_GROUP_FIRST are reserved */
     uint8_t addr;
 
+    /** \brief   multicast groups of the node
+     *  \details bit n is set if the node is the member of group n */
+    uint16_t groups;
+
+    /** \brief bus which the node is connected to */
+    sysbus* bus;
+
+    /** \brief execution time of the handler */
+    sysbus_histogram timing;
+
+    /** \brief join the multicast group
+     *
+     *  \param group number of the group */
+    void subscribe(uint8_t group)
+    { if (group < SYSBUS_GROUPS) { groups |= (uint16_t)(1 << group); } }
+
+    /** \brief leave the multicast group
+     *
+     *  \param group number of the group */
+    void unsubscribe(uint8_t group)
+    { if (group < SYSBUS_GROUPS) { groups &= (uint16_t)~(1 << group); } }
+
+    /** \brief check that messages to the address should be handled by node
+     *
+     *  \param dst destination address of the message
+     *
+     *  \return result of check
+     *  \retval true  node is the recepient of the message
+     *  \retval false message isn't for this node */
+    bool accepts(uint8_t dst) const
+    { if (dst == SYSBUS_BROADCAST) { return true; }
+
+      if (dst >= SYSBUS_GROUP_FIRST)
+      { return groups & (1 << (dst - SYSBUS_GROUP_FIRST)); }
+
+      return dst == addr; }
+
     /** \brief   handler of the requests to the current node
      *  \details you should implement it in your own node
      *
@@ -20,6 +726,12 @@ class i_sysbus_node : public automatic_list<i_sysbus_node>
      *  \param src  address of the sender */
     virtual void handler(uint8_t* data, uint8_t size, uint16_t src) = 0;
 
+    /** \brief   periodic call of the node
+     *  \details called by the bus every poll, use it for timeouts
+     *
+     *  \param now current time in ticks */
+    virtual void tick(uint32_t now) { (void)now; }
+
     /** \brief   send message to the system bus
      *  \details first loopback would be scanned for recepients and if there
      *           is no any recepient it would be sent to the bus
@@ -27,7 +739,14 @@ class i_sysbus_node : public automatic_list<i_sysbus_node>
      *  \param data pointer to the data that should be sent
      *  \param size size of the data that should be sent
      *  \param dst  destination node on the bus
-     *  \param ttl  time to live of the message */
-    void signal(uint8_t* data, uint8_t size, uint8_t dst, uint8_t ttl); };
+     *  \param ttl  time to live of the message
+     *  \param prio priority of the transmission
+     *
+     *  \return error code, see sysbus::send() */
+    uint8_t signal(uint8_t* data,
+                   uint8_t size,
+                   uint8_t dst,
+                   uint8_t ttl,
+                   uint8_t prio = SYSBUS_PRIORITY_NORMAL); };
 
 #endif // SYSBUS_HPP
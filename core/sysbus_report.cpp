@@ -0,0 +1,50 @@
+/** \file  sysbus_report.cpp
+ *  \brief human readable report of the system bus state */
+
+#include <cstdint>
+#include "containers/automatic_list.hpp"
+#include "core/sysbus.hpp"
+#include "io/print.hpp"
+
+/** \brief width of the name column of the report */
+#define REPORT_NAME 16
+
+/** \brief print one line of the report
+ *
+ *  \param out   output
+ *  \param name  name of the value
+ *  \param value value */
+static void line(print& out, const char* name, uint32_t value)
+{ out.s(name, REPORT_NAME).u(value).s("\n"); }
+
+void sysbus::report(print& out)
+{ line(out, "received", stats.received);
+  line(out, "delivered", stats.delivered);
+  line(out, "retranslated", stats.retranslated);
+  line(out, "transmitted", stats.transmitted);
+  line(out, "crc errors", parser.errors);
+  line(out, "expired", stats.expired);
+  line(out, "oversized", stats.oversized);
+  line(out, "unreachable", stats.unreachable);
+  line(out, "overflows", stats.overflows);
+  line(out, "incomplete", stats.incomplete);
+  i_sysbus_node* node = automatic_list<i_sysbus_node>::root;
+
+  while (node)
+  { if (node->bus == this)
+    { out.s("node ").u(node->addr).s(": ").u(node->timing.calls)
+      .s(" calls, max ").u(node->timing.max).s("\n");
+
+      for (uint32_t i = 0; i < SYSBUS_HISTOGRAM; i++)
+      { if (!node->timing.buckets[i]) { continue; }
+
+        // upper bound of the bucket, the last one has only lower bound
+        uint32_t bound = (uint32_t)1 << i;
+        const char* prefix = "  < ";
+
+        if (i + 1 == SYSBUS_HISTOGRAM) { bound >>= 1; prefix = "  >= "; }
+
+        out.s(prefix).u(bound, 10, 0, ALIGN_RIGHT)
+        .s(": ").u(node->timing.buckets[i]).s("\n"); } }
+
+    node = node->next; } }
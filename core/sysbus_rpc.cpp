@@ -0,0 +1,108 @@
+/** \file  sysbus_rpc.cpp
+ *  \brief request-response calls over the system bus */
+
+#include <cstdint>
+#include <cstring>
+#include "core/errcode.hpp"
+#include "core/sysbus.hpp"
+#include "core/sysbus_rpc.hpp"
+
+static_assert(SYSBUS_RPC_PENDING <= SYSBUS_RPC_ID,
+              "there is not enough correlation ids for pending calls");
+
+i_sysbus_rpc_node::i_sysbus_rpc_node(sysbus& bus) : i_sysbus_node(bus),
+  ttl(SYSBUS_RPC_TTL), prio(SYSBUS_PRIORITY_NORMAL), next_id(0) { }
+
+uint8_t i_sysbus_rpc_node::transfer(uint8_t dst,
+                                    uint8_t header,
+                                    uint8_t* data,
+                                    uint8_t size)
+{ if (size > SYSBUS_RPC_DATA_SIZE || (size && !data))
+  { return ERR_INVALID_ARGUMENT; }
+
+  uint8_t message[SYSBUS_MESSAGE_SIZE];
+  message[0] = header;
+
+  if (size) { memcpy(&message[1], data, size); }
+
+  return signal(message, size + 1, dst, ttl, prio); }
+
+uint8_t i_sysbus_rpc_node::call(uint8_t dst,
+                                uint8_t* data,
+                                uint8_t size,
+                                uint32_t timeout,
+                                uint8_t* id)
+{ if (dst >= SYSBUS_GROUP_FIRST) { return ERR_INVALID_ARGUMENT; }
+
+  sysbus_rpc_call* slot = nullptr;
+
+  for (sysbus_rpc_call& c : calls)
+  { if (!c.busy) { slot = &c; break; } }
+
+  if (!slot) { return ERR_BUSY; }
+
+  // id of the pending call is not reused, there is less calls than ids
+  bool used = true;
+
+  while (used)
+  { next_id = (next_id + 1) & SYSBUS_RPC_ID;
+    used = false;
+
+    for (sysbus_rpc_call& c : calls)
+    { if (c.busy && c.id == next_id) { used = true; } } }
+
+  // the slot is taken before the request is sent because local callee
+  // answers immediately
+  slot->busy = true;
+  slot->id = next_id;
+  slot->dst = dst;
+  slot->started = bus->polled;
+  slot->timeout = timeout;
+  uint8_t call_id = next_id;
+
+  if (id) { *id = call_id; }
+
+  uint8_t errcode = transfer(dst, call_id, data, size);
+
+  if (errcode != ERR_OK) { cancel(call_id); }
+
+  return errcode; }
+
+uint8_t i_sysbus_rpc_node::reply(uint8_t dst,
+                                 uint8_t id,
+                                 uint8_t* data,
+                                 uint8_t size)
+{ return transfer(dst, SYSBUS_RPC_RESPONSE | (id & SYSBUS_RPC_ID), data,
+                  size); }
+
+void i_sysbus_rpc_node::cancel(uint8_t id)
+{ for (sysbus_rpc_call& c : calls)
+  { if (c.busy && c.id == id) { c.busy = false; } } }
+
+uint8_t i_sysbus_rpc_node::pending() const
+{ uint8_t count = 0;
+
+  for (const sysbus_rpc_call& c : calls) { count += c.busy; }
+
+  return count; }
+
+void i_sysbus_rpc_node::handler(uint8_t* data, uint8_t size, uint16_t src)
+{ if (!size) { return; }
+
+  uint8_t id = data[0] & SYSBUS_RPC_ID;
+
+  if (!(data[0] & SYSBUS_RPC_RESPONSE))
+  { request(id, &data[1], size - 1, (uint8_t)src);
+    return; }
+
+  for (sysbus_rpc_call& c : calls)
+  { if (c.busy && c.id == id && c.dst == src)
+    { c.busy = false;
+      response(id, ERR_OK, &data[1], size - 1);
+      return; } } }
+
+void i_sysbus_rpc_node::tick(uint32_t now)
+{ for (sysbus_rpc_call& c : calls)
+  { if (c.busy && now - c.started >= c.timeout)
+    { c.busy = false;
+      response(c.id, ERR_TIMEOUT, nullptr, 0); } } }
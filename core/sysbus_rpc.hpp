@@ -0,0 +1,161 @@
+/** \file  sysbus_rpc.hpp
+ *  \brief request-response calls over the system bus
+ *  \details first byte of every rpc message is its header: highest bit is
+ *           set in the responses, other bits are the correlation id of the
+ *           call. many calls may be in flight at once, the responses are
+ *           matched to the calls by the id and the address of the callee */
+
+#ifndef SYSBUS_RPC_HPP
+#define SYSBUS_RPC_HPP
+
+#include <cstdint>
+#include "core/sysbus.hpp"
+
+/** \defgroup sysbus_rpc_config
+ *  \brief    rpc configuration
+ *  \{ */
+
+/** \brief number of the calls of one node that can wait for the response */
+#ifndef SYSBUS_RPC_PENDING
+  #define SYSBUS_RPC_PENDING 8
+#endif
+
+/** \brief default time in ticks to wait for the response */
+#ifndef SYSBUS_RPC_TIMEOUT
+  #define SYSBUS_RPC_TIMEOUT 100
+#endif
+
+/** \brief default time to live of the rpc messages, enough for full ring */
+#ifndef SYSBUS_RPC_TTL
+  #define SYSBUS_RPC_TTL 15
+#endif
+
+/** \brief bit of the header that marks the response */
+#define SYSBUS_RPC_RESPONSE 0x80
+
+/** \brief bits of the header that contain the correlation id */
+#define SYSBUS_RPC_ID 0x7F
+
+/** \brief maximum size of the arguments or the result of the call */
+#define SYSBUS_RPC_DATA_SIZE (SYSBUS_MESSAGE_SIZE - 1)
+/** \} */
+
+/** \brief call that waits for the response */
+class sysbus_rpc_call
+{ public:
+    sysbus_rpc_call() : busy(false) {}
+
+    /** \brief slot is used */
+    bool busy;
+
+    /** \brief correlation id */
+    uint8_t id;
+
+    /** \brief address of the callee */
+    uint8_t dst;
+
+    /** \brief time of the call */
+    uint32_t started;
+
+    /** \brief time to wait for the response */
+    uint32_t timeout; };
+
+/** \brief   node that makes and serves non-blocking calls
+ *  \details call() sends the request and returns at once, the result comes
+ *           later to response() with the same id. if there is no response in
+ *           time response() gets ERR_TIMEOUT. incoming requests come to
+ *           request(), answer them with reply() right there or later */
+class i_sysbus_rpc_node : public i_sysbus_node
+{ public:
+    /** \brief constructor
+     *
+     *  \param bus bus which the node is connected to */
+    explicit i_sysbus_rpc_node(sysbus& bus = system_bus);
+
+    /** \brief start the call
+     *
+     *  \param dst     address of the callee
+     *  \param data    pointer to the arguments
+     *  \param size    size of the arguments
+     *  \param timeout time in ticks to wait for the response
+     *  \param id      pointer to store correlation id of the call, may be null
+     *
+     *  \return error code
+     *  \retval ERR_OK               request is sent
+     *  \retval ERR_INVALID_ARGUMENT arguments are too large or dst is group
+     *  \retval ERR_BUSY             too many calls are pending or the
+     *                               transmission queue is full */
+    uint8_t call(uint8_t dst,
+                 uint8_t* data,
+                 uint8_t size,
+                 uint32_t timeout = SYSBUS_RPC_TIMEOUT,
+                 uint8_t* id = nullptr);
+
+    /** \brief answer the request
+     *
+     *  \param dst  address of the caller
+     *  \param id   correlation id of the request
+     *  \param data pointer to the result
+     *  \param size size of the result
+     *
+     *  \return error code, see sysbus::send() */
+    uint8_t reply(uint8_t dst, uint8_t id, uint8_t* data, uint8_t size);
+
+    /** \brief drop the call, its response will be ignored
+     *
+     *  \param id correlation id of the call */
+    void cancel(uint8_t id);
+
+    /** \brief number of calls that wait for the response
+     *
+     *  \return number of calls */
+    uint8_t pending() const;
+
+    /** \brief   handler of the incoming request
+     *  \details you should implement it in your own node
+     *
+     *  \param id   correlation id, pass it to reply()
+     *  \param data pointer to the arguments
+     *  \param size size of the arguments
+     *  \param src  address of the caller */
+    virtual void request(uint8_t id, uint8_t* data, uint8_t size,
+                         uint8_t src) = 0;
+
+    /** \brief   completion of the call
+     *  \details you should implement it in your own node
+     *
+     *  \param id      correlation id of the call
+     *  \param errcode ERR_OK or ERR_TIMEOUT
+     *  \param data    pointer to the result, null on timeout
+     *  \param size    size of the result */
+    virtual void response(uint8_t id, uint8_t errcode, uint8_t* data,
+                          uint8_t size) = 0;
+
+    virtual void handler(uint8_t* data, uint8_t size, uint16_t src) override;
+
+    virtual void tick(uint32_t now) override;
+
+    /** \brief time to live of the requests and the responses */
+    uint8_t ttl;
+
+    /** \brief priority of the requests and the responses */
+    uint8_t prio;
+
+    /** \brief calls that wait for the response */
+    sysbus_rpc_call calls[SYSBUS_RPC_PENDING];
+
+  private:
+    /** \brief send rpc message
+     *
+     *  \param dst    destination node
+     *  \param header header of the message
+     *  \param data   pointer to the data
+     *  \param size   size of the data
+     *
+     *  \return error code, see sysbus::send() */
+    uint8_t transfer(uint8_t dst, uint8_t header, uint8_t* data, uint8_t size);
+
+    /** \brief correlation id of the next call */
+    uint8_t next_id; };
+
+#endif // SYSBUS_RPC_HPP
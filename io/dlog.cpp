@@ -0,0 +1,168 @@
+/** \file dlog.cpp
+ *  \brief implementation of the deferred binary log */
+
+#include <cstdint>
+#include <cstring>
+#include "io/dlog.hpp"
+#include "bsp/bsp.h"
+
+/** \brief ring of the records, free bytes are always zero */
+static uint8_t ring[DLOG_SIZE];
+
+/** \brief free running position of the next reservation */
+static uint32_t head = 0;
+
+/** \brief free running position of the oldest record */
+static uint32_t tail = 0;
+
+/** \brief number of the dropped records that are reported */
+static uint32_t reported = 0;
+
+/** \brief   position of the first record that is dropped after the report
+ *  \details report is sent after the records that are older */
+static uint32_t gap = 0;
+
+uint32_t dlog::dropped = 0;
+
+/** \brief count the dropped record
+ *
+ *  \param h position of the head */
+static void drop(uint32_t h)
+{ // first drop after the report sets the position
+  if (__atomic_load_n(&dlog::dropped, __ATOMIC_RELAXED) ==
+      __atomic_load_n(&reported, __ATOMIC_ACQUIRE))
+  { __atomic_store_n(&gap, h, __ATOMIC_RELAXED); }
+
+#if __GCC_ATOMIC_INT_LOCK_FREE == 2
+  __atomic_fetch_add(&dlog::dropped, 1, __ATOMIC_RELEASE); }
+#else
+  // the interrupts are disabled by the caller
+  __atomic_store_n(&dlog::dropped, dlog::dropped + 1, __ATOMIC_RELEASE); }
+#endif
+
+#if __GCC_ATOMIC_INT_LOCK_FREE == 2
+/** \brief   reserve the space in the ring
+ *  \details lock-free, head is moved by compare and swap
+ *
+ *  \param len size of the record
+ *  \param h   position of the record
+ *
+ *  \return true if the record fits */
+static bool reserve(uint32_t len, uint32_t& h)
+{ h = __atomic_load_n(&head, __ATOMIC_RELAXED);
+
+  do
+  { uint32_t t = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+
+    if (len > DLOG_SIZE - (h - t))
+    { drop(h);
+      return false; } }
+  while (!__atomic_compare_exchange_n(&head, &h, h + len, true,
+                                      __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+  return true; }
+#else
+/** \brief   reserve the space in the ring
+ *  \details the core has no compare and swap, like cortex-m0 or rv32
+ *           without atomic extension, and the compiler would call
+ *           libatomic, so the interrupts are disabled for a few
+ *           instructions
+ *
+ *  \param len size of the record
+ *  \param h   position of the record
+ *
+ *  \return true if the record fits */
+static bool reserve(uint32_t len, uint32_t& h)
+{ bsp_enter_critical();
+  h = head;
+  uint32_t t = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+  bool fits = len <= DLOG_SIZE - (h - t);
+
+  if (fits) { head = h + len; }
+  else { drop(h); }
+
+  bsp_leave_critical();
+  return fits; }
+#endif
+
+void dlog::commit(uint8_t* rec, uint32_t len)
+{ uint32_t h;
+
+  if (!reserve(len, h)) { return; }
+
+  // body is copied first, records are short and the loop is cheaper than
+  // the call of memcpy, it also wraps the end of the ring
+  for (uint32_t i = 1; i < len; i++) { ring[(h + i) % DLOG_SIZE] = rec[i]; }
+
+  __atomic_store_n(&ring[h % DLOG_SIZE], (uint8_t)len, __ATOMIC_RELEASE); }
+
+uint32_t dlog::drain(uint32_t free,
+                     void (*send)(void* ctx, const uint8_t*, uint32_t),
+                     void* ctx)
+{ uint32_t sent = 0;
+  uint32_t t = tail;
+
+  while (true)
+  { uint32_t lost = __atomic_load_n(&dlog::dropped, __ATOMIC_ACQUIRE);
+
+    // the report goes after the records that were in the ring when the
+    // first of them was dropped
+    if (lost != reported && t == __atomic_load_n(&gap, __ATOMIC_RELAXED))
+    { uint8_t rec[DLOG_HEADER + sizeof(lost)];
+
+      if (free < sizeof(rec)) { break; }
+
+      uint32_t id = DLOG_DROPPED_ID;
+      uint32_t count = lost - reported;
+      rec[0] = sizeof(rec);
+      memcpy(rec + 1, &id, sizeof(id));
+      memcpy(rec + DLOG_HEADER, &count, sizeof(count));
+      send(ctx, rec, sizeof(rec));
+      __atomic_store_n(&reported, lost, __ATOMIC_RELEASE);
+
+      // records dropped while the report was sent didn't set the position,
+      // they are reported after the records that are in the ring now
+      if (__atomic_load_n(&dlog::dropped, __ATOMIC_ACQUIRE) != lost)
+      { __atomic_store_n(&gap, __atomic_load_n(&head, __ATOMIC_ACQUIRE),
+                         __ATOMIC_RELAXED); }
+      sent += sizeof(rec);
+      free -= sizeof(rec); }
+
+    uint32_t pos = t % DLOG_SIZE;
+    uint8_t len = __atomic_load_n(&ring[pos], __ATOMIC_ACQUIRE);
+
+    // zero length is the record that is not complete yet
+    if (!len || len > free) { break; }
+
+    uint32_t piece = DLOG_SIZE - pos;
+
+    if (piece > len) { piece = len; }
+
+    send(ctx, ring + pos, piece);
+    memset(ring + pos, 0, piece);
+
+    if (piece < len)
+    { send(ctx, ring, len - piece);
+      memset(ring, 0, len - piece); }
+
+    t += len;
+    sent += len;
+    free -= len;
+    __atomic_store_n(&tail, t, __ATOMIC_RELEASE); }
+
+  return sent; }
+
+/** \brief sends the piece of the records to the console */
+static void send_console(void* ctx, const uint8_t* data, uint32_t len)
+{ (void)ctx;
+  bsp_tx_block((const char*)data, len); }
+
+/** \brief writes the piece of the records to the pipe */
+static void send_pipe(void* ctx, const uint8_t* data, uint32_t len)
+{ ((i_pipe*)ctx)->write((void*)data, len); }
+
+uint32_t dlog::drain()
+{ return drain(bsp_tx_available(), send_console, nullptr); }
+
+uint32_t dlog::drain(i_pipe& p)
+{ return drain(p.size() - p.fullness(), send_pipe, &p); }
@@ -0,0 +1,246 @@
+/** \file dlog.hpp
+ *  \brief deferred binary log, text is made on the host */
+
+#ifndef DLOG_HPP
+#define DLOG_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "core/pipe.hpp"
+#include "io/print.hpp"
+
+/** \defgroup dlog_flags
+ *  \brief    settings of the deferred log
+ *  \{ */
+
+/** \brief size of the ring of the records, power of two */
+#ifndef DLOG_SIZE
+  #define DLOG_SIZE 1024
+#endif
+
+/** \brief maximum number of the characters of the %s argument */
+#ifndef DLOG_STRING_MAX
+  #define DLOG_STRING_MAX 32
+#endif
+
+/** \brief   id of the record that reports the dropped records
+ *  \details its only argument is uint32_t number of the dropped records */
+#define DLOG_DROPPED_ID 0
+
+/** \brief size of the header of the record: length and id */
+#define DLOG_HEADER 5
+
+/** \brief marker of the entries of the string table in the firmware */
+#define DLOG_MAGIC "\x7f" "DLOG"
+
+/** \brief size of the marker */
+#define DLOG_MAGIC_SIZE 5
+
+/** \} */
+
+static_assert(!(DLOG_SIZE & (DLOG_SIZE - 1)), "size must be power of two");
+
+/** \brief   type code of the argument
+ *  \details codes are the same as in python struct module, 's' is the string
+ *           with the length byte */
+template <typename TYPE>
+constexpr char dlog_code()
+{ if constexpr (std::is_floating_point<TYPE>::value)
+  { return (sizeof(TYPE) == 4) ? 'f' : 'd'; }
+  else if constexpr (std::is_same<TYPE, char>::value) { return 'c'; }
+  else if constexpr (std::is_pointer<TYPE>::value) { return 's'; }
+  else if constexpr (std::is_signed<TYPE>::value)
+  { return (sizeof(TYPE) == 1) ? 'b' : (sizeof(TYPE) == 2) ? 'h' :
+           (sizeof(TYPE) == 4) ? 'i' : 'q'; }
+  else
+  { return (sizeof(TYPE) == 1) ? 'B' : (sizeof(TYPE) == 2) ? 'H' :
+           (sizeof(TYPE) == 4) ? 'I' : 'Q'; } }
+
+/** \brief size of the argument in the record, strings are counted apart */
+template <typename TYPE>
+constexpr uint32_t dlog_size()
+{ return (std::is_pointer<TYPE>::value) ? 1 : sizeof(TYPE); }
+
+/** \brief length of the string */
+constexpr uint32_t dlog_length(const char* str)
+{ uint32_t len = 0;
+
+  while (str[len]) { len++; }
+
+  return len; }
+
+/** \brief   id of the entry of the string table
+ *  \details 32 bit FNV-1a hash of the type codes, zero and the format
+ *
+ *  \param str text of the entry
+ *  \param len length of the text
+ *
+ *  \return id, never DLOG_DROPPED_ID */
+constexpr uint32_t dlog_hash(const char* str, uint32_t len)
+{ uint32_t hash = 2166136261u;
+
+  for (uint32_t i = 0; i < len; i++)
+  { hash = (hash ^ (uint8_t)str[i]) * 16777619u; }
+
+  return (hash == DLOG_DROPPED_ID) ? 1 : hash; }
+
+/** \brief entry of the string table: marker, type codes, zero, format */
+template <uint32_t N>
+class dlog_text
+{ public:
+    /** \brief text of the entry terminated by zero */
+    char data[N]; };
+
+/** \brief make the entry of the string table at compile time */
+template <typename FORMAT, typename... ARGS, uint32_t... I>
+constexpr dlog_text<sizeof...(I)> dlog_make(std::integer_sequence<uint32_t,
+                                                                   I...>)
+{ constexpr uint32_t args = DLOG_MAGIC_SIZE + sizeof...(ARGS);
+  constexpr char head[] = { DLOG_MAGIC[0], DLOG_MAGIC[1], DLOG_MAGIC[2],
+                            DLOG_MAGIC[3], DLOG_MAGIC[4],
+                            dlog_code<ARGS>()..., '\0' };
+  return { { ((I <= args) ? head[I] : FORMAT::str()[I - args - 1])... } }; }
+
+/** \brief   entry of the string table for the format and the arguments
+ *  \details one static entry is made by the compiler for every call, host
+ *           finds the entries in the firmware by the marker */
+template <typename FORMAT, typename... ARGS>
+class dlog_entry
+{ public:
+    /** \brief size of the entry */
+    static constexpr uint32_t size = DLOG_MAGIC_SIZE + sizeof...(ARGS) + 1 +
+                                     dlog_length(FORMAT::str()) + 1;
+
+    /** \brief entry */
+    static constexpr dlog_text<size> text =
+      dlog_make<FORMAT, ARGS...>(std::make_integer_sequence<uint32_t, size>());
+
+    /** \brief id of the records, known at compile time */
+    static constexpr uint32_t id = dlog_hash(text.data + DLOG_MAGIC_SIZE,
+                                             size - DLOG_MAGIC_SIZE - 1); };
+
+/** \brief   deferred log
+ *  \details the call stores id of the format and raw bytes of the arguments
+ *           in the ring, text is made by tools/dlog_decode on the host. the
+ *           string table is built at compile time: every call places the
+ *           entry with the marker, type codes and the format to the
+ *           firmware, id is the hash of the entry. the host finds the
+ *           entries in the firmware image. the ring is lock-free, write()
+ *           may be called from any context including interrupts. on the
+ *           cores without compare and swap, like cortex-m0, the space is
+ *           reserved with the interrupts disabled by bsp_enter_critical().
+ *           records that don't fit are dropped and counted, the report is
+ *           sent after the records that were in the ring at the first drop
+ *
+ *  \code
+ *  dlog::write(PRINT_FMT("adc %u: %.3f V"), channel, volts);
+ *  \endcode */
+class dlog
+{ public:
+    /** \brief   write the record
+     *  \details format is checked against the arguments at compile time like
+     *           print::fmt() does
+     *
+     *  \param format format string made by PRINT_FMT
+     *  \param args   values */
+    template <typename FORMAT, typename... ARGS>
+    static void write(FORMAT format, const ARGS&... args)
+    { static_assert(std::is_base_of<print_format, FORMAT>::value,
+                    "format string must be made by PRINT_FMT");
+      constexpr uint32_t count = print_format_count(FORMAT::str());
+      static_assert(print_format_args(FORMAT::str(), count) ==
+                    sizeof...(ARGS),
+                    "number of the arguments doesn't match the format");
+      (void)format;
+      check<FORMAT>(std::make_integer_sequence<uint32_t, count>(), args...);
+
+      using ENTRY = dlog_entry<FORMAT, typename std::decay<ARGS>::type...>;
+      constexpr uint32_t strings =
+        (0 + ... + std::is_pointer<typename std::decay<ARGS>::type>::value);
+      constexpr uint32_t fixed =
+        (DLOG_HEADER + ... + dlog_size<typename std::decay<ARGS>::type>());
+      static_assert(fixed + strings * DLOG_STRING_MAX <= 255,
+                    "record is too long");
+
+      // the entry is referenced, so the linker keeps it for the host
+      asm volatile ("" : : "r"(ENTRY::text.data));
+      uint8_t rec[fixed + strings * DLOG_STRING_MAX];
+      uint32_t id = ENTRY::id;
+      memcpy(rec + 1, &id, sizeof(id));
+      uint32_t len = DLOG_HEADER;
+      (put(rec, len, args), ...);
+      commit(rec, len); }
+
+    /** \brief   send the records to the console
+     *  \details only whole records that fit bsp_tx_available() are sent
+     *
+     *  \return number of the sent bytes */
+    static uint32_t drain();
+
+    /** \brief   send the records to the pipe
+     *  \details only whole records that fit the free space of the pipe are
+     *           written, the rest waits for the next call
+     *
+     *  \param p pipe
+     *
+     *  \return number of the written bytes */
+    static uint32_t drain(i_pipe& p);
+
+    /** \brief number of the dropped records */
+    static uint32_t dropped;
+
+  private:
+    /** \brief check all of the arguments */
+    template <typename FORMAT, uint32_t... I, typename... ARGS>
+    static void check(std::integer_sequence<uint32_t, I...>,
+                      const ARGS&... args)
+    { (check_spec<FORMAT, I>(args...), ...); }
+
+    /** \brief check the argument of the conversion */
+    template <typename FORMAT, uint32_t I, typename... ARGS>
+    static void check_spec(const ARGS&... args)
+    { constexpr char type = print_format_parse(FORMAT::str(), I).type;
+
+      if constexpr (type != '%')
+      { constexpr uint32_t arg = print_format_args(FORMAT::str(), I);
+        using VALUE = decltype(print_format_arg<arg>(args...));
+        print_format_check<FORMAT, I, VALUE>(); } }
+
+    /** \brief add raw bytes of the argument to the record */
+    template <typename VALUE>
+    static void put(uint8_t* rec, uint32_t& len, const VALUE& value)
+    { if constexpr (std::is_pointer<typename std::decay<VALUE>::type>::value)
+      { const char* str = value;
+        uint32_t n = 0;
+
+        while (n < DLOG_STRING_MAX && str[n]) { n++; }
+
+        rec[len] = (uint8_t)n;
+        memcpy(rec + len + 1, str, n);
+        len += n + 1; }
+      else
+      { memcpy(rec + len, &value, sizeof(value));
+        len += sizeof(value); } }
+
+    /** \brief   reserve the space in the ring and copy the record
+     *  \details length byte is written last, it marks the record as
+     *           complete
+     *
+     *  \param rec record, first byte is filled here
+     *  \param len size of the record */
+    static void commit(uint8_t* rec, uint32_t len);
+
+    /** \brief send the records by the sink
+     *
+     *  \param free   free space of the sink
+     *  \param send   sends the piece of the data
+     *  \param ctx    context of the sink
+     *
+     *  \return number of the sent bytes */
+    static uint32_t drain(uint32_t free,
+                          void (*send)(void* ctx, const uint8_t*, uint32_t),
+                          void* ctx); };
+
+#endif // DLOG_HPP
@@ -0,0 +1,42 @@
+/** \file log.cpp
+ *  \brief implementation of the runtime levels of the log */
+
+#include <cstdint>
+#include <cstring>
+#include "io/log.hpp"
+#include "core/errcode.hpp"
+
+uint8_t logger::level = LOG_LEVEL;
+logger::entry logger::entries[LOG_MODULES];
+uint32_t logger::count = 0;
+
+uint32_t logger::find(const char* module)
+{ for (uint32_t i = 0; i < count; i++)
+  { if (entries[i].name == module) { return i; } }
+
+  for (uint32_t i = 0; i < count; i++)
+  { if (!strcmp(entries[i].name, module)) { return i; } }
+
+  return count; }
+
+uint8_t logger::set(const char* module, uint8_t lvl)
+{ uint32_t i = find(module);
+
+  if (i == count)
+  { if (count == LOG_MODULES) { return ERR_BUFFER_OVERFLOW; }
+
+    entries[i].name = module;
+    count++; }
+
+  entries[i].level = lvl;
+  return ERR_OK; }
+
+uint8_t logger::get(const char* module)
+{ uint32_t i = find(module);
+  return (i == count) ? level : entries[i].level; }
+
+print& logger::head(print& out, uint8_t lvl, const char* module)
+{ static const char letters[] = "TDIWE";
+  char letter[2] = { letters[(lvl < LOG_LEVEL_NONE) ? lvl : LOG_LEVEL_ERROR],
+                     '\0' };
+  return out(letter)(" ")(module)(": "); }
@@ -0,0 +1,143 @@
+/** \file log.hpp
+ *  \brief leveled log of the kernel modules on top of print */
+
+#ifndef LOG_HPP
+#define LOG_HPP
+
+#include <cstdint>
+#include "core/module.hpp"
+#include "io/print.hpp"
+
+/** \defgroup log_flags
+ *  \brief    levels and settings of the log
+ *  \{ */
+
+/** \brief details of the execution */
+#define LOG_LEVEL_TRACE 0
+
+/** \brief debug output */
+#define LOG_LEVEL_DEBUG 1
+
+/** \brief normal events */
+#define LOG_LEVEL_INFO 2
+
+/** \brief something unexpected, module keeps working */
+#define LOG_LEVEL_WARN 3
+
+/** \brief module can't do its job */
+#define LOG_LEVEL_ERROR 4
+
+/** \brief nothing is logged */
+#define LOG_LEVEL_NONE 5
+
+/** \brief   compile time threshold
+ *  \details statements below it are removed with their arguments */
+#ifndef LOG_LEVEL
+  #define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+/** \brief maximum number of the modules with their own runtime level */
+#ifndef LOG_MODULES
+  #define LOG_MODULES 8
+#endif
+
+/** \} */
+
+/** \brief   runtime levels of the modules
+ *  \details modules are identified by i_kernel_module::name, modules without
+ *           their own level use logger::level */
+class logger
+{ public:
+    /** \brief level of the modules that have no their own one */
+    static uint8_t level;
+
+    /** \brief   set the level of the module
+     *  \details LOG_LEVEL_NONE mutes the module
+     *
+     *  \param module name of the module
+     *  \param lvl    level
+     *
+     *  \return ERR_OK or ERR_BUFFER_OVERFLOW if there are more than
+     *          LOG_MODULES modules */
+    static uint8_t set(const char* module, uint8_t lvl);
+
+    /** \brief   get the level of the module
+     *  \details the name is compared by pointer first, then by text
+     *
+     *  \param module name of the module
+     *
+     *  \return level */
+    static uint8_t get(const char* module);
+
+    /** \brief check if the statement of the module is shown
+     *
+     *  \param lvl    level of the statement
+     *  \param module name of the module
+     *
+     *  \return true if it's shown */
+    static bool enabled(uint8_t lvl, const char* module)
+    { return (!count) ? lvl >= level : lvl >= get(module); }
+
+    /** \brief   print the head of the line: level letter and the module
+     *
+     *  \param out    output
+     *  \param lvl    level of the statement
+     *  \param module name of the module
+     *
+     *  \return output */
+    static print& head(print& out, uint8_t lvl, const char* module);
+
+  private:
+    /** \brief module with its own level */
+    class entry
+    { public:
+        const char* name;
+        uint8_t     level; };
+
+    /** \brief modules with their own level */
+    static entry entries[LOG_MODULES];
+
+    /** \brief number of the used entries */
+    static uint32_t count;
+
+    /** \brief find the entry of the module
+     *
+     *  \param module name of the module
+     *
+     *  \return index of the entry or count if there is no one */
+    static uint32_t find(const char* module); };
+
+/** \brief   log the line of the module to the console
+ *  \details statement below LOG_LEVEL is removed at compile time, the
+ *           runtime level of the module is checked before the arguments are
+ *           evaluated. format is made by PRINT_FMT and checked like
+ *           print::fmt() does, new line is added. module is evaluated twice
+ *
+ *  \code
+ *  LOG_WARN(*this, PRINT_FMT("queue %u is full"), prio);
+ *  \endcode */
+#define LOG(lvl, module, ...)                                               \
+  do                                                                        \
+  { if constexpr ((lvl) >= LOG_LEVEL)                                       \
+    { if (logger::enabled((lvl), (module).name))                            \
+      { print log_line;                                                     \
+        logger::head(log_line, (lvl), (module).name).fmt(__VA_ARGS__)       \
+        ("\n"); } } }                                                       \
+  while (0)
+
+/** \brief log the details of the execution */
+#define LOG_TRACE(module, ...) LOG(LOG_LEVEL_TRACE, module, __VA_ARGS__)
+
+/** \brief log the debug output */
+#define LOG_DEBUG(module, ...) LOG(LOG_LEVEL_DEBUG, module, __VA_ARGS__)
+
+/** \brief log the normal event */
+#define LOG_INFO(module, ...) LOG(LOG_LEVEL_INFO, module, __VA_ARGS__)
+
+/** \brief log the warning */
+#define LOG_WARN(module, ...) LOG(LOG_LEVEL_WARN, module, __VA_ARGS__)
+
+/** \brief log the error */
+#define LOG_ERROR(module, ...) LOG(LOG_LEVEL_ERROR, module, __VA_ARGS__)
+
+#endif // LOG_HPP
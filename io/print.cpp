@@ -7,13 +7,66 @@
 #include "io/print.hpp"
 #include "bsp/bsp.h"
 
-print::print() : errcode(ERR_OK), buffer(nullptr), size(0), counter(0) { }
+static_assert(PRINT_LINE_SIZE > 0, "console needs line buffer");
+
+/** \brief console output that is not sent yet */
+static char line[PRINT_LINE_SIZE];
+
+/** \brief number of the characters in the line buffer */
+static uint32_t line_used = 0;
+
+bool print::blocking = true;
+
+uint32_t print::dropped = 0;
+
+/** \brief send the line buffer to the console in one block */
+static void send_line()
+{ if (!line_used) { return; }
+
+  if (!print::blocking && bsp_tx_available() < line_used)
+  { print::dropped += line_used; }
+  else { bsp_tx_block(line, line_used); }
+
+  line_used = 0; }
+
+print::print()
+  : errcode(ERR_OK),
+    buffer(nullptr),
+    size(0),
+    counter(0),
+    sink(nullptr),
+    skip(0),
+    stretch(false)
+{ }
+
+print::print(i_print_sink& sink, uint32_t skip)
+  : errcode(ERR_OK),
+    buffer(nullptr),
+    size(0),
+    counter(0),
+    sink(&sink),
+    skip(skip),
+    stretch(false)
+{ }
+
+print::~print()
+{ if (!buffer && !sink) { send_line(); } }
+
+print& print::flush()
+{ if (!buffer && !sink)
+  { send_line();
+    bsp_tx_flush(); }
+
+  return *this; }
 
 print::print(char* buffer, uint32_t size)
   : errcode(ERR_OK),
     buffer(buffer),
     size(size),
-    counter(0)
+    counter(0),
+    sink(nullptr),
+    skip(0),
+    stretch(false)
 { }
 
 print& print::operator()(const char* str,
@@ -52,6 +105,16 @@ print& print::s(char* str,
   print_string((char*)str, len, align, spc);
   return *this; }
 
+print& print::terminate() { return t(); }
+
+print& print::t()
+{ if (!buffer) { return *this; }
+
+  if (counter < size) { buffer[counter] = '\0'; }
+  else { errcode = ERR_BUFFER_OVERFLOW; }
+
+  return *this; }
+
 void print::print_string(char* str,
                          uint32_t len,
                          uint8_t align,
@@ -61,14 +124,25 @@ void print::print_string(char* str,
 
   while (*_str) { actual_len++; _str++; }
 
-  uint32_t space = 0;
+  put(str, actual_len, len, align, spc); }
+
+void print::put(const char* str,
+                uint32_t actual_len,
+                uint32_t len,
+                uint8_t align,
+                char spc)
+{ uint32_t space = 0;
   bool make_brackets = false;
 
+  if (len && stretch && actual_len > len) { len = actual_len; }
+
   if (len)
   { space = len - actual_len;
 
+    // brackets take two characters of the space, so nothing is left of the
+    // string if the space is shorter
     if (actual_len > len)
-    { actual_len = len - 2;
+    { actual_len = (len > 2) ? len - 2 : 0;
       space = 0;
       make_brackets = true; } }
 
@@ -86,118 +160,1013 @@ void print::print_string(char* str,
 
   for (uint32_t i = 0; i < space_before; i++) { tx(spc); }
 
-  for (uint32_t i = 0; i < actual_len; i++) { tx(str[i]); }
+  tx(str, actual_len);
 
   for (uint32_t i = 0; i < space - space_before; i++) { tx(spc); }
 
   if (make_brackets) { tx(']'); } }
 
 /** \brief   table of 10 power
- *  \details as this printing methow 32-only bit maximum used power is 9 */
-static uint32_t pow10[10] =
-{ /*  0 */ 1,
-  /*  1 */ 10,
-  /*  2 */ 100,
-  /*  3 */ 1000,
-  /*  4 */ 10000,
-  /*  5 */ 100000,
-  /*  6 */ 1000000,
-  /*  7 */ 10000000,
-  /*  8 */ 100000000,
-  /*  9 */ 1000000000 };
+ *  \details used to count decimal digits of 64 bit values */
+static const uint64_t pow10[20] =
+{ /*  0 */ 1ULL,
+  /*  1 */ 10ULL,
+  /*  2 */ 100ULL,
+  /*  3 */ 1000ULL,
+  /*  4 */ 10000ULL,
+  /*  5 */ 100000ULL,
+  /*  6 */ 1000000ULL,
+  /*  7 */ 10000000ULL,
+  /*  8 */ 100000000ULL,
+  /*  9 */ 1000000000ULL,
+  /* 10 */ 10000000000ULL,
+  /* 11 */ 100000000000ULL,
+  /* 12 */ 1000000000000ULL,
+  /* 13 */ 10000000000000ULL,
+  /* 14 */ 100000000000000ULL,
+  /* 15 */ 1000000000000000ULL,
+  /* 16 */ 10000000000000000ULL,
+  /* 17 */ 100000000000000000ULL,
+  /* 18 */ 1000000000000000000ULL,
+  /* 19 */ 10000000000000000000ULL };
+
+/** \brief   pairs of decimal digits from 00 to 99
+ *  \details two digits are produced by one division */
+static const char digit_pairs[201] =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536"
+  "37383940414243444546474849505152535455565758596061626364656667686970717273"
+  "7475767778798081828384858687888990919293949596979899";
 
 /** \brief table for integer to char transform, uppercase variant */
-static char asciitab_uppercase[16] =
+static const char asciitab_uppercase[16] =
 { '0', '1', '2', '3', '4', '5', '6', '7',
   '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
 
 /** \brief table for integer to char transform, lowercase variant */
-static char asciitab_lowercase[16] =
+static const char asciitab_lowercase[16] =
 { '0', '1', '2', '3', '4', '5', '6', '7',
   '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
 
-print& print::u(uint32_t uint,
+/** \brief   number of decimal digits of the value
+ *  \details log10 is estimated by number of significant bits as
+ *           bits * 1233 / 4096 and corrected by one comparison
+ *
+ *  \param val value
+ *
+ *  \return number of digits, at least 1 */
+static uint32_t decimal_digits(uint64_t val)
+{ uint32_t bits = 64 - __builtin_clzll(val | 1);
+  uint32_t digits = (bits * 1233) >> 12;
+  digits += (val >= pow10[digits]);
+  return (digits) ? digits : 1; }
+
+/** \brief   write decimal digits backwards
+ *  \details 32 bit values use 32 bit divisions, they are much cheaper on
+ *           small cores
+ *
+ *  \tparam TYPE type of the value
+ *  \param  end  position after the last digit
+ *  \param  val  value */
+template <typename TYPE>
+static void write_decimal(char* end, TYPE val)
+{ while (val >= 100)
+  { uint32_t pair = (uint32_t)(val % 100) * 2;
+    val /= 100;
+    end -= 2;
+    memcpy(end, &digit_pairs[pair], 2); }
+
+  if (val >= 10) { memcpy(end - 2, &digit_pairs[val * 2], 2); }
+  else { end[-1] = (char)('0' + val); } }
+
+/** \brief write decimal digits of the value
+ *
+ *  \param out buffer of at least 20 characters
+ *  \param val value
+ *
+ *  \return number of digits */
+static uint32_t decimal(char* out, uint64_t val)
+{ uint32_t len = decimal_digits(val);
+
+  if (val <= UINT32_MAX) { write_decimal<uint32_t>(out + len, (uint32_t)val); }
+  else { write_decimal<uint64_t>(out + len, val); }
+
+  return len; }
+
+/** \brief write digits of the value in the base that is power of two
+ *
+ *  \param out   buffer of at least 64 characters
+ *  \param val   value
+ *  \param shift bits per digit
+ *  \param table digit characters
+ *  \param min   minimum number of digits, leading zeros are added
+ *
+ *  \return number of digits */
+static uint32_t radix(char* out, uint64_t val, uint32_t shift,
+                      const char* table, uint32_t min = 0)
+{ uint32_t bits = 64 - __builtin_clzll(val | 1);
+  uint32_t len = (bits + shift - 1) / shift;
+  uint32_t mask = (1u << shift) - 1;
+
+  if (len < min) { len = min; }
+
+  for (char* p = out + len; p != out; )
+  { p--;
+    *p = table[val & mask];
+    val >>= shift; }
+
+  return len; }
+
+void print::number(const char* digits,
+                   uint32_t count,
+                   char sign,
+                   uint8_t separate_num,
+                   uint32_t len,
+                   uint8_t align,
+                   char spc)
+{ if (!sign && (!separate_num || separate_num >= count))
+  { put(digits, count, len, align, spc);
+    return; }
+
+  char temp[PRINT_NUMBER_SIZE];
+  uint32_t n = 0;
+
+  if (sign) { temp[n++] = sign; }
+
+  if (!separate_num || separate_num >= count)
+  { memcpy(temp + n, digits, count);
+    n += count; }
+  else
+  { // separators are placed from the right, so the first group may be short
+    uint32_t group = count % separate_num;
+
+    if (!group) { group = separate_num; }
+
+    memcpy(temp + n, digits, group);
+    n += group;
+
+    for (uint32_t i = group; i < count; i += separate_num)
+    { temp[n++] = ' ';
+      memcpy(temp + n, digits + i, separate_num);
+      n += separate_num; } }
+
+  put(temp, n, len, align, spc); }
+
+print& print::u(uint64_t uint,
                 uint32_t len,
                 uint8_t separate_num,
                 uint8_t align,
                 char spc)
 { if (errcode) { return *this; }
 
-  uint32_t rest = uint;
-  uint8_t digit_counter = 0;
-  char temp[9 + 9] = { 0 };
-  bool first_significant_arrived = false;
+  char digits[20];
+  uint32_t count = decimal(digits, uint);
+  number(digits, count, 0, separate_num, len, align, spc);
+  return *this; }
 
-  for (uint8_t i = 9; i <= 9; i--)
-  { uint8_t current_digit = 0;
-    current_digit = rest / pow10[i];
-    rest -= current_digit * pow10[i];
+print& print::i(int64_t sint,
+                uint32_t len,
+                uint8_t separate_num,
+                bool print_plus,
+                uint8_t align,
+                char spc)
+{ if (errcode) { return *this; }
 
-    if (current_digit) { first_significant_arrived = true; }
+  char digits[20];
+  uint64_t magnitude = (sint < 0) ? 0 - (uint64_t)sint : (uint64_t)sint;
+  char sign = (sint < 0) ? '-' : (print_plus) ? '+' : 0;
+  uint32_t count = decimal(digits, magnitude);
+  number(digits, count, sign, separate_num, len, align, spc);
+  return *this; }
 
-    if (!current_digit && !first_significant_arrived) { continue; }
+print& print::x(uint64_t uint,
+                uint8_t digits,
+                uint32_t len,
+                uint8_t separate_num,
+                uint8_t align,
+                char spc)
+{ if (errcode) { return *this; }
 
-    temp[digit_counter] = asciitab_uppercase[current_digit];
-    digit_counter++; }
+  if (digits > 16) { errcode = ERR_INVALID_ARGUMENT; return *this; }
 
-  // insert separators
-  uint32_t actual_len = digit_counter;
+  char temp[16];
+  uint32_t count = radix(temp, uint, 4, asciitab_lowercase, digits);
+  number(temp, count, 0, separate_num, len, align, spc);
+  return *this; }
 
-  if (separate_num && separate_num < digit_counter)
-  { uint32_t current_pos = digit_counter;
+print& print::X(uint64_t uint,
+                uint32_t len,
+                uint8_t separate_num,
+                uint8_t align,
+                char spc)
+{ if (errcode) { return *this; }
 
-    for (uint32_t i = 0; i < digit_counter; i++)
-    { if (i && (i % separate_num == 0))
-      { memcpy(&temp[current_pos + 1],
-               &temp[current_pos],
-               actual_len - current_pos);
-        temp[current_pos] = ' ';
-        actual_len++; }
+  char temp[16];
+  uint32_t count = radix(temp, uint, 4, asciitab_uppercase);
+  number(temp, count, 0, separate_num, len, align, spc);
+  return *this; }
 
-      current_pos--; } }
+print& print::o(uint64_t uint,
+                uint32_t len,
+                uint8_t separate_num,
+                uint8_t align,
+                char spc)
+{ if (errcode) { return *this; }
+
+  char temp[22];
+  uint32_t count = radix(temp, uint, 3, asciitab_uppercase);
+  number(temp, count, 0, separate_num, len, align, spc);
+  return *this; }
+
+print& print::b(uint64_t uint,
+                uint32_t len,
+                uint8_t separate_num,
+                uint8_t align,
+                char spc)
+{ if (errcode) { return *this; }
 
-  s(temp, len, align, spc);
+  char temp[64];
+  uint32_t count = radix(temp, uint, 1, asciitab_uppercase);
+  number(temp, count, 0, separate_num, len, align, spc);
   return *this; }
 
-/** \brief extracts one hexadecimal digit from value
+/** \brief   number of 32 bit words of the big integer
+ *  \details enough for 2^1140, the largest intermediate value of the double
+ *           conversion */
+#define PRINT_BIGNUM_WORDS 40
+
+/** \brief maximum number of the integer digits of double and carry */
+#define PRINT_FLOAT_DIGITS 310
+
+/** \brief number of the fraction digits, shortest form may have 22 */
+#define PRINT_FRACTION_SIZE \
+  ((PRINT_FLOAT_PRECISION > 22) ? PRINT_FLOAT_PRECISION : 22)
+
+/** \brief maximum size of the formatted floating point value: sign, integer
+ *         digits and their separators, point, fraction and exponent */
+#define PRINT_FLOAT_SIZE \
+  (1 + PRINT_FLOAT_DIGITS * 2 + 1 + PRINT_FRACTION_SIZE + 5)
+
+/** \brief maximum number of the integer digits of the value below 2^64 and
+ *         carry, also of the shortest form without exponent */
+#define PRINT_SHORT_DIGITS 21
+
+/** \brief maximum size of the formatted value below 2^64 */
+#define PRINT_SHORT_SIZE \
+  (1 + PRINT_SHORT_DIGITS * 2 + 1 + PRINT_FRACTION_SIZE + 5)
+
+#if defined(__SIZEOF_INT128__)
+/** \brief native 128 bit value of the short conversions */
+__extension__ typedef unsigned __int128 print_wide;
+#endif
+
+/** \brief   unsigned big integer for exact floating point conversion
+ *  \details words are little endian, only used words are processed, so
+ *           small values are cheap */
+class print_bignum
+{ public:
+    /** \brief 32 bit words, low first */
+    uint32_t w[PRINT_BIGNUM_WORDS];
+
+    /** \brief number of the used words, highest one is not zero */
+    uint32_t used;
+
+    /** \brief set 64 bit value */
+    void set(uint64_t val)
+    { w[0] = (uint32_t)val;
+      w[1] = (uint32_t)(val >> 32);
+      used = (w[1]) ? 2 : (w[0]) ? 1 : 0; }
+
+    /** \brief copy the used words of other value */
+    void set(const print_bignum& val)
+    { used = val.used;
+      memcpy(w, val.w, used * sizeof(uint32_t)); }
+
+#if defined(__SIZEOF_INT128__)
+    /** \brief value of up to four words */
+    print_wide wide() const
+    { print_wide val = 0;
+
+      for (uint32_t i = used; i-- > 0; ) { val = (val << 32) | w[i]; }
+
+      return val; }
+#endif
+
+    /** \brief check if the value is zero */
+    bool zero() const { return !used; }
+
+    /** \brief drop the zero words from the top */
+    void trim() { while (used && !w[used - 1]) { used--; } }
+
+    /** \brief multiply by 2^bits */
+    void shl(uint32_t bits)
+    { if (!used) { return; }
+
+      uint32_t words = bits / 32;
+      uint32_t rest = bits % 32;
+
+      if (rest)
+      { uint32_t carry = 0;
+
+        for (uint32_t i = 0; i < used; i++)
+        { uint32_t val = w[i];
+          w[i] = (val << rest) | carry;
+          carry = val >> (32 - rest); }
+
+        if (carry) { w[used++] = carry; } }
+
+      if (words)
+      { for (uint32_t i = used; i-- > 0; ) { w[i + words] = w[i]; }
+
+        memset(w, 0, words * sizeof(uint32_t));
+        used += words; } }
+
+    /** \brief multiply by small value */
+    void mul(uint32_t m)
+    { uint64_t carry = 0;
+
+      for (uint32_t i = 0; i < used; i++)
+      { uint64_t val = (uint64_t)w[i] * m + carry;
+        w[i] = (uint32_t)val;
+        carry = val >> 32; }
+
+      if (carry) { w[used++] = (uint32_t)carry; } }
+
+    /** \brief multiply by 10^exp, nine digits per step */
+    void mul_pow10(uint32_t exp)
+    { for (; exp >= 9; exp -= 9) { mul(1000000000); }
+
+      if (exp) { mul((uint32_t)pow10[exp]); } }
+
+    /** \brief add other value */
+    void add(const print_bignum& val)
+    { uint32_t n = (used > val.used) ? used : val.used;
+      uint64_t carry = 0;
+
+      for (uint32_t i = 0; i < n; i++)
+      { uint64_t sum = carry;
+        sum += (i < used) ? w[i] : 0;
+        sum += (i < val.used) ? val.w[i] : 0;
+        w[i] = (uint32_t)sum;
+        carry = sum >> 32; }
+
+      used = n;
+
+      if (carry) { w[used++] = (uint32_t)carry; } }
+
+    /** \brief subtract other value, it must not be greater */
+    void sub(const print_bignum& val)
+    { uint32_t borrow = 0;
+
+      for (uint32_t i = 0; i < used; i++)
+      { uint64_t diff = (uint64_t)w[i] - ((i < val.used) ? val.w[i] : 0)
+                        - borrow;
+        w[i] = (uint32_t)diff;
+        borrow = (uint32_t)(diff >> 63); }
+
+      trim(); }
+
+    /** \brief add two values in one pass */
+    void sum(const print_bignum& a, const print_bignum& b)
+    { used = 0;
+      add(a);
+      add(b); }
+
+    /** \brief   divide by other value, the quotient must be less than 10
+     *  \details quotient is estimated by the top words, divisor with 29
+     *           bits in the top word makes it at most one less than the
+     *           right one
+     *  \return  quotient, the value is replaced by the remainder */
+    uint32_t divmod(const print_bignum& d)
+    { uint32_t n = d.used;
+
+      if (used < n) { return 0; }
+
+      uint64_t top = w[n - 1];
+
+      if (used > n) { top |= (uint64_t)w[n] << 32; }
+
+      uint32_t q = (uint32_t)(top / ((uint64_t)d.w[n - 1] + 1));
+
+      if (q)
+      { uint64_t carry = 0;
+        uint32_t borrow = 0;
+
+        for (uint32_t i = 0; i < used; i++)
+        { uint64_t prod = carry;
+          prod += (i < n) ? (uint64_t)d.w[i] * q : 0;
+          carry = prod >> 32;
+          uint64_t diff = (uint64_t)w[i] - (uint32_t)prod - borrow;
+          w[i] = (uint32_t)diff;
+          borrow = (uint32_t)(diff >> 63); }
+
+        trim(); }
+
+      while (cmp(d) >= 0)
+      { sub(d);
+        q++; }
+
+      return q; }
+
+    /** \brief compare with other value
+     *  \return negative, zero or positive like memcmp */
+    int32_t cmp(const print_bignum& val) const
+    { if (used != val.used) { return (used > val.used) ? 1 : -1; }
+
+      for (uint32_t i = used; i-- > 0; )
+      { if (w[i] != val.w[i]) { return (w[i] > val.w[i]) ? 1 : -1; } }
+
+      return 0; }
+
+    /** \brief divide by small value
+     *  \return remainder */
+    uint32_t div(uint32_t d)
+    { uint64_t rem = 0;
+
+      for (uint32_t i = used; i-- > 0; )
+      { uint64_t cur = (rem << 32) | w[i];
+        w[i] = (uint32_t)(cur / d);
+        rem = cur % d; }
+
+      trim();
+      return (uint32_t)rem; }
+
+    /** \brief   split the value by the bit
+     *  \details bits from the position and higher are cleared, they must
+     *           fit 32 bits
+     *  \return  value of the cleared bits */
+    uint32_t split(uint32_t bit)
+    { uint32_t word = bit / 32;
+      uint32_t rest = bit % 32;
+
+      if (word >= used) { return 0; }
+
+      uint64_t high = w[word] >> rest;
+
+      if (word + 1 < used) { high |= (uint64_t)w[word + 1] << (32 - rest); }
+
+      if (rest)
+      { w[word] &= (1u << rest) - 1;
+        used = word + 1; }
+      else { used = word; }
+
+      trim();
+      return (uint32_t)high; } };
+
+/** \brief big integers of the conversion, they are too large for the stack */
+static print_bignum big_r, big_s, big_plus, big_minus, big_t;
+
+/** \brief integer digits of the value from 2^64 */
+static char float_int[PRINT_FLOAT_DIGITS];
+
+/** \brief assembled value from 2^64 */
+static char float_text[PRINT_FLOAT_SIZE];
+
+/** \brief   decimal digits of the big integer
+ *  \details nine digits are produced by one division of the whole value
+ *
+ *  \param out buffer of PRINT_FLOAT_DIGITS characters
+ *  \param val value, it's destroyed
  *
- *  \param value target value
- *  \param pos   number of digit to be extracted */
-#define HEX_DIGIT(value, pos) \
-((value & ((uint32_t)0x0F << (pos * 4))) >> (pos * 4))
+ *  \return number of digits */
+static uint32_t big_decimal(char* out, print_bignum& val)
+{ char* p = out + PRINT_FLOAT_DIGITS;
 
-print& print::x(uint32_t uint,
-                uint8_t digits,
+  while (val.used > 2)
+  { p -= 9;
+    memset(p, '0', 9);
+    write_decimal<uint32_t>(p + 9, val.div(1000000000)); }
+
+  uint64_t top = val.w[0];
+
+  if (val.used > 1) { top |= (uint64_t)val.w[1] << 32; }
+
+  char head[20];
+  uint32_t n = decimal(head, top);
+  uint32_t tail = (uint32_t)(out + PRINT_FLOAT_DIGITS - p);
+  memmove(out + n, p, tail);
+  memcpy(out, head, n);
+  return n + tail; }
+
+/** \brief   exact digits of m * 2^e with fixed number of the fraction digits
+ *  \details fraction below the binary point is multiplied by 10 for every
+ *           digit, values that fit 64 bits don't touch the big integers.
+ *           rest of the fraction rounds the last digit half to even
+ *
+ *  \param m    mantissa
+ *  \param e    binary exponent
+ *  \param prec number of the fraction digits
+ *  \param ints buffer for the integer digits, PRINT_FLOAT_DIGITS characters
+ *              for the value from 2^64 and PRINT_SHORT_DIGITS below it
+ *  \param frac buffer for prec fraction digits
+ *
+ *  \return number of the integer digits */
+static uint32_t fixed_digits(uint64_t m, int32_t e, uint32_t prec,
+                             char* ints, char* frac)
+{ uint32_t count;
+  bool up = false;
+
+  if (!m || e >= 0)
+  { if (!m) { count = decimal(ints, 0); }
+    else if (64 - __builtin_clzll(m) + e <= 64)
+    { count = decimal(ints, m << e); }
+    else
+    { big_r.set(m);
+      big_r.shl(e);
+      count = big_decimal(ints, big_r); }
+
+    memset(frac, '0', prec);
+    return count; }
+
+  uint32_t k = -e;
+  count = decimal(ints, (k < 64) ? m >> k : 0);
+  char last = ints[count - 1];
+
+  if (k <= 60)
+  { uint64_t mask = (1ULL << k) - 1;
+    uint64_t rest = m & mask;
+
+    for (uint32_t i = 0; i < prec; i++)
+    { rest *= 10;
+      frac[i] = (char)('0' + (rest >> k));
+      rest &= mask; }
+
+    if (prec) { last = frac[prec - 1]; }
+
+    uint64_t half = 1ULL << (k - 1);
+    up = rest > half || (rest == half && (last & 1)); }
+  else
+  { big_r.set((k < 64) ? m & ((1ULL << k) - 1) : m);
+
+    for (uint32_t i = 0; i < prec; i++)
+    { if (big_r.zero())
+      { memset(frac + i, '0', prec - i);
+        break; }
+
+      big_r.mul(10);
+      frac[i] = (char)('0' + big_r.split(k)); }
+
+    if (prec) { last = frac[prec - 1]; }
+
+    big_s.set(1);
+    big_s.shl(k - 1);
+    int32_t c = big_r.cmp(big_s);
+    up = c > 0 || (c == 0 && (last & 1)); }
+
+  if (!up) { return count; }
+
+  uint32_t i = prec;
+
+  while (i && frac[i - 1] == '9') { frac[--i] = '0'; }
+
+  if (i)
+  { frac[i - 1]++;
+    return count; }
+
+  i = count;
+
+  while (i && ints[i - 1] == '9') { ints[--i] = '0'; }
+
+  if (i) { ints[i - 1]++; }
+  else
+  { memmove(ints + 1, ints, count);
+    ints[0] = '1';
+    count++; }
+
+  return count; }
+
+#if defined(__SIZEOF_INT128__)
+/** \brief   digit loop of shortest_digits() on the native 128 bit values
+ *  \details s is below 2^123, so ten times the sum of r and plus fits
+ *
+ *  \param r     value
+ *  \param s     scale
+ *  \param plus  half of the gap to the upper neighbour
+ *  \param minus half of the gap to the lower neighbour
+ *  \param even  neighbours are read back to the value
+ *  \param out   buffer for 17 digits
+ *
+ *  \return number of the digits */
+static uint32_t shortest_wide(print_wide r, print_wide s, print_wide plus,
+                              print_wide minus, bool even, char* out)
+{ uint32_t n = 0;
+
+  while (true)
+  { r *= 10;
+    plus *= 10;
+    minus *= 10;
+    uint32_t d = (uint32_t)(r / s);
+    r -= s * d;
+    bool low = r < minus || (r == minus && even);
+    bool high = r + plus > s || (r + plus == s && even);
+
+    if (low && high)
+    { if ((r << 1) > s || ((r << 1) == s && (d & 1))) { d++; } }
+    else if (high) { d++; }
+
+    out[n++] = (char)('0' + d);
+
+    if (low || high) { return n; } } }
+#endif
+
+/** \brief   shortest digits of m * 2^e that read back to the same value
+ *  \details free-format algorithm of Steele, White, Burger and Dybvig on
+ *           the big integers. value is r / s, the neighbours are half of the
+ *           gap away, that is plus / s and minus / s. digits are produced
+ *           until the rest is inside the gap
+ *
+ *  \param m     mantissa, not zero
+ *  \param e     binary exponent
+ *  \param bits  precision of the type in bits
+ *  \param out   buffer for 17 digits
+ *  \param point position of the decimal point from the first digit
+ *
+ *  \return number of the digits */
+static uint32_t shortest_digits(uint64_t m, int32_t e, uint32_t bits,
+                                char* out, int32_t& point)
+{ int32_t min_e = (bits > 24) ? -1074 : -149;
+  bool even = !(m & 1);
+  // lower neighbour is twice closer at the power of two
+  bool boundary = (m == 1ULL << (bits - 1)) && e != min_e;
+  uint32_t shift = (boundary) ? 2 : 1;
+
+  if (e >= 0)
+  { big_r.set(m);
+    big_r.shl(e + shift);
+    big_s.set(1ULL << shift);
+    big_plus.set(1);
+    big_plus.shl(e + shift - 1);
+    big_minus.set(1);
+    big_minus.shl(e); }
+  else
+  { big_r.set(m << shift);
+    big_s.set(1);
+    big_s.shl(shift - e);
+    big_plus.set(1ULL << (shift - 1));
+    big_minus.set(1); }
+
+  // first estimation of the point is lower by one or two
+  int32_t magnitude = 63 - __builtin_clzll(m) + e;
+  int32_t k = (int32_t)(((int64_t)magnitude * 78913) >> 18) - 1;
+
+  if (k >= 0) { big_s.mul_pow10(k); }
+  else
+  { big_r.mul_pow10(-k);
+    big_plus.mul_pow10(-k);
+    big_minus.mul_pow10(-k); }
+
+  while (true)
+  { big_t.sum(big_r, big_plus);
+    int32_t c = big_t.cmp(big_s);
+
+    if (c < 0 || (c == 0 && !even)) { break; }
+
+    big_s.mul(10);
+    k++; }
+
+  point = k;
+
+#if defined(__SIZEOF_INT128__)
+  if (big_s.used < 4 || (big_s.used == 4 && big_s.w[3] < (1u << 27)))
+  { return shortest_wide(big_r.wide(), big_s.wide(), big_plus.wide(),
+                         big_minus.wide(), even, out); }
+#endif
+
+  // all of the values are scaled, so the top word of s has 29 bits
+  uint32_t top = 32 - __builtin_clz(big_s.w[big_s.used - 1]);
+  uint32_t scale = (top <= 29) ? 29 - top : 61 - top;
+  big_s.shl(scale);
+  big_r.shl(scale);
+  big_plus.shl(scale);
+  big_minus.shl(scale);
+  uint32_t n = 0;
+
+  while (true)
+  { big_r.mul(10);
+    big_plus.mul(10);
+    big_minus.mul(10);
+    uint32_t d = big_r.divmod(big_s);
+    int32_t c = big_r.cmp(big_minus);
+    bool low = c < 0 || (c == 0 && even);
+    big_t.sum(big_r, big_plus);
+    c = big_t.cmp(big_s);
+    bool high = c > 0 || (c == 0 && even);
+
+    if (low && high)
+    { // both are in the gap, the closer one is taken
+      big_t.set(big_r);
+      big_t.shl(1);
+      c = big_t.cmp(big_s);
+
+      if (c > 0 || (c == 0 && (d & 1))) { d++; } }
+    else if (high) { d++; }
+
+    out[n++] = (char)('0' + d);
+
+    if (low || high) { return n; } } }
+
+/** \brief   assemble the floating point value
+ *
+ *  \param out          buffer for the text
+ *  \param sign         sign character, 0 for none
+ *  \param ints         integer digits
+ *  \param int_count    number of the integer digits
+ *  \param separate_num number of characters between separator spaces
+ *  \param frac         fraction digits
+ *  \param frac_count   number of the fraction digits, 0 for no point
+ *  \param exp          decimal exponent
+ *  \param has_exp      exponent is printed
+ *
+ *  \return length of the text */
+static uint32_t float_assemble(char* out,
+                               char sign,
+                               const char* ints,
+                               uint32_t int_count,
+                               uint8_t separate_num,
+                               const char* frac,
+                               uint32_t frac_count,
+                               int32_t exp,
+                               bool has_exp)
+{ uint32_t n = 0;
+
+  if (sign) { out[n++] = sign; }
+
+  if (!separate_num || separate_num >= int_count)
+  { memcpy(out + n, ints, int_count);
+    n += int_count; }
+  else
+  { uint32_t group = int_count % separate_num;
+
+    if (!group) { group = separate_num; }
+
+    memcpy(out + n, ints, group);
+    n += group;
+
+    for (uint32_t i = group; i < int_count; i += separate_num)
+    { out[n++] = ' ';
+      memcpy(out + n, ints + i, separate_num);
+      n += separate_num; } }
+
+  if (frac_count)
+  { out[n++] = '.';
+    memcpy(out + n, frac, frac_count);
+    n += frac_count; }
+
+  if (has_exp)
+  { out[n++] = 'e';
+    out[n++] = (exp < 0) ? '-' : '+';
+    n += decimal(out + n, (exp < 0) ? -exp : exp); }
+
+  return n; }
+
+void print::real(uint64_t m,
+                 int32_t e,
+                 uint32_t bits,
+                 char sign,
+                 uint32_t prec,
+                 uint8_t separate_num,
+                 uint32_t len,
+                 uint8_t align,
+                 char spc)
+{ char ints[PRINT_SHORT_DIGITS];
+  char frac[PRINT_FRACTION_SIZE];
+  char text[PRINT_SHORT_SIZE];
+  uint32_t n;
+
+  // value from 2^64 may have hundreds of the digits, they don't fit the
+  // stack
+  bool huge = m && e >= 0 && 64 - __builtin_clzll(m) + e > 64;
+
+  if (prec != PRINT_SHORTEST && huge)
+  { uint32_t count = fixed_digits(m, e, prec, float_int, frac);
+    n = float_assemble(float_text, sign, float_int, count, separate_num, frac,
+                       prec, 0, false);
+    put(float_text, n, len, align, spc);
+    return; }
+
+  if (prec != PRINT_SHORTEST)
+  { uint32_t count = fixed_digits(m, e, prec, ints, frac);
+    n = float_assemble(text, sign, ints, count, separate_num, frac, prec, 0,
+                       false); }
+  else if (!m)
+  { n = float_assemble(text, sign, "0", 1, 0, nullptr, 0, 0, false); }
+  else
+  { char digits[17];
+    int32_t point;
+    int32_t count = (int32_t)shortest_digits(m, e, bits, digits, point);
+
+    if (point < -5 || point > 21)
+    { n = float_assemble(text, sign, digits, 1, 0, digits + 1, count - 1,
+                         point - 1, true); }
+    else if (point <= 0)
+    { memset(frac, '0', -point);
+      memcpy(frac - point, digits, count);
+      n = float_assemble(text, sign, "0", 1, 0, frac, count - point, 0,
+                         false); }
+    else if (point >= count)
+    { memcpy(ints, digits, count);
+      memset(ints + count, '0', point - count);
+      n = float_assemble(text, sign, ints, point, separate_num, nullptr, 0, 0,
+                         false); }
+    else
+    { n = float_assemble(text, sign, digits, point, separate_num,
+                         digits + point, count - point, 0, false); } }
+
+  put(text, n, len, align, spc); }
+
+print& print::f(float flt,
+                uint32_t prec,
                 uint32_t len,
                 uint8_t separate_num,
+                bool print_plus,
                 uint8_t align,
                 char spc)
 { if (errcode) { return *this; }
 
-  if (!digits || !len) { errcode = ERR_INVALID_ARGUMENT; return *this; }
+  if (prec > PRINT_FLOAT_PRECISION && prec != PRINT_SHORTEST)
+  { errcode = ERR_INVALID_ARGUMENT;
+    return *this; }
+
+  uint32_t raw;
+  memcpy(&raw, &flt, sizeof(raw));
+  uint32_t exp = (raw >> 23) & 0xFF;
+  uint64_t m = raw & 0x7FFFFF;
+  char sign = (raw >> 31) ? '-' : (print_plus) ? '+' : 0;
+
+  if (exp == 0xFF)
+  { if (m) { put("nan", 3, len, align, spc); }
+    else { number("inf", 3, sign, 0, len, align, spc); }
+
+    return *this; }
+
+  // denormals have no hidden bit and the exponent of the smallest normal
+  if (exp) { m |= 1ULL << 23; }
 
-  char temp[8 * 2] = { 0 };
+  real(m, (exp) ? (int32_t)exp - 150 : -149, 24, sign, prec, separate_num,
+       len, align, spc);
+  return *this; }
 
-  for (uint8_t i = 0; i < digits; i++)
-  { temp[i] = asciitab_lowercase[HEX_DIGIT(uint, i)]; }
+print& print::f(double flt,
+                uint32_t prec,
+                uint32_t len,
+                uint8_t separate_num,
+                bool print_plus,
+                uint8_t align,
+                char spc)
+{ if (errcode) { return *this; }
+
+  if (prec > PRINT_FLOAT_PRECISION && prec != PRINT_SHORTEST)
+  { errcode = ERR_INVALID_ARGUMENT;
+    return *this; }
 
-  // insert separators
-  if (separate_num && separate_num < digits)
-  { uint32_t current_pos = digits;
+  uint64_t raw;
+  memcpy(&raw, &flt, sizeof(raw));
+  uint32_t exp = (raw >> 52) & 0x7FF;
+  uint64_t m = raw & 0xFFFFFFFFFFFFFULL;
+  char sign = (raw >> 63) ? '-' : (print_plus) ? '+' : 0;
 
-    for (uint32_t i = 0; i < digits; i++)
-    { if (i && (i % separate_num == 0))
-      { memcpy(&temp[current_pos + 1],
-               &temp[current_pos],
-               digits - current_pos);
-        temp[current_pos] = ' '; }
+  if (exp == 0x7FF)
+  { if (m) { put("nan", 3, len, align, spc); }
+    else { number("inf", 3, sign, 0, len, align, spc); }
 
-      current_pos--; } }
+    return *this; }
 
-  s(temp, len, align, spc);
+  if (exp) { m |= 1ULL << 52; }
+
+  real(m, (exp) ? (int32_t)exp - 1075 : -1074, 53, sign, prec, separate_num,
+       len, align, spc);
   return *this; }
 
+/** \brief alignment of the conversion */
+static uint8_t spec_align(const print_spec& spec)
+{ return (spec.left) ? ALIGN_LEFT : ALIGN_RIGHT; }
+
+/** \brief number of the digits between the separators of the conversion */
+static uint8_t spec_sep(const print_spec& spec)
+{ if (!spec.group) { return 0; }
+
+  return (spec.type == 'x' || spec.type == 'X' || spec.type == 'b') ? 4 : 3; }
+
+/** \brief precision of the float conversion */
+static uint32_t spec_prec(const print_spec& spec)
+{ if (spec.type == 'g') { return PRINT_SHORTEST; }
+
+  return (spec.prec == UINT32_MAX) ? STD_PRECISION_DIGITS : spec.prec; }
+
+print& print::value(const print_spec& spec, uint64_t raw)
+{ uint8_t align = spec_align(spec);
+  uint8_t sep = spec_sep(spec);
+  char spc = (spec.zero) ? '0' : ' ';
+  char ch[2] = { (char)raw, '\0' };
+  stretch = true;
+
+  switch (spec.type)
+  { case 'd':
+    case 'i': i((int64_t)raw, spec.width, sep, spec.plus, align); break;
+
+    case 'u': u(raw, spec.width, sep, align, spc);                break;
+
+    case 'o': o(raw, spec.width, sep, align, spc);                break;
+
+    case 'b': b(raw, spec.width, sep, align, spc);                break;
+
+    case 'X': X(raw, spec.width, sep, align);                     break;
+
+    case 'x':
+      if (spec.zero) { x(raw, spec.width, 0, sep); }
+      else { x(raw, 0, spec.width, sep, align); }
+
+      break;
+
+    case 'c': s(ch, spec.width, align);                           break;
+
+    default: errcode = ERR_INVALID_ARGUMENT;                      break; }
+
+  stretch = false;
+  return *this; }
+
+print& print::value(const print_spec& spec, float flt)
+{ stretch = true;
+  f(flt, spec_prec(spec), spec.width, spec_sep(spec), spec.plus,
+    spec_align(spec));
+  stretch = false;
+  return *this; }
+
+print& print::value(const print_spec& spec, double flt)
+{ stretch = true;
+  f(flt, spec_prec(spec), spec.width, spec_sep(spec), spec.plus,
+    spec_align(spec));
+  stretch = false;
+  return *this; }
+
+print& print::value(const print_spec& spec, const char* str)
+{ stretch = true;
+  s(str, spec.width, spec_align(spec));
+  stretch = false;
+  return *this; }
+
+__attribute__((weak)) void bsp_tx_block(const char* data, uint32_t len)
+{ while (len) { bsp_tx_char(*data); data++; len--; } }
+
+__attribute__((weak)) uint32_t bsp_tx_available()
+{ return UINT32_MAX; }
+
+__attribute__((weak)) void bsp_tx_flush() {}
+
+void print::tx_sink(const char* str, uint32_t n)
+{ // nothing is written after the gap left by the full sink
+  if (errcode) { return; }
+
+  if (counter < skip)
+  { uint32_t piece = (skip - counter < n) ? skip - counter : n;
+    counter += piece;
+    str += piece;
+    n -= piece;
+
+    if (!n) { return; } }
+
+  uint32_t accepted = sink->write(str, n);
+  counter += accepted;
+
+  if (accepted < n) { errcode = ERR_BUSY; } }
+
+void print::tx(const char* str, uint32_t n)
+{ if (sink)
+  { tx_sink(str, n);
+    return; }
+
+  if (!buffer)
+  { while (n)
+    { uint32_t piece = PRINT_LINE_SIZE - line_used;
+
+      if (piece > n) { piece = n; }
+
+      const char* nl = (const char*)memchr(str, '\n', piece);
+
+      if (nl) { piece = (uint32_t)(nl - str) + 1; }
+
+      memcpy(line + line_used, str, piece);
+      line_used += piece;
+      str += piece;
+      n -= piece;
+
+      if (nl || line_used == PRINT_LINE_SIZE) { send_line(); } }
+
+    return; }
+
+  // counter never exceeds size, so the rest of the buffer doesn't wrap
+  if (n > size - counter)
+  { n = size - counter;
+    errcode = ERR_BUFFER_OVERFLOW; }
+
+  memcpy(buffer + counter, str, n);
+  counter += n; }
+
 void print::tx(char ch)
-{ if (!buffer) { bsp_tx_char(ch); }
+{ if (sink) { tx_sink(&ch, 1); }
+  else if (!buffer)
+  { line[line_used] = ch;
+    line_used++;
+
+    if (ch == '\n' || line_used == PRINT_LINE_SIZE) { send_line(); } }
   else if (counter < size) { buffer[counter] = ch; counter++; }
   else { errcode = ERR_BUFFER_OVERFLOW; } }
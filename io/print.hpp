@@ -5,6 +5,8 @@
 #define PRINT_HPP
 
 #include <cstdint>
+#include <type_traits>
+#include <utility>
 #include "bsp/bsp.h"
 
 /** \defgroup print_flags
@@ -32,8 +34,227 @@
 /** \brief default alignment */
 #define STD_ALIGN ALIGN_LEFT
 
+/** \brief   size of the console line buffer
+ *  \details console output is collected here and sent by bsp_tx_block() on
+ *           new line, when the buffer is full, on flush() and when the
+ *           printing object is destroyed
+ *  \warning the line buffer is shared without locking, so console print
+ *           must not be used from interrupts. print to the buffer or use
+ *           dlog there */
+#ifndef PRINT_LINE_SIZE
+  #define PRINT_LINE_SIZE 64
+#endif
+
+/** \brief maximum size of the formatted number: 64 binary digits, their
+ *         separators and sign */
+#define PRINT_NUMBER_SIZE (64 + 63 + 1)
+
+/** \brief   precision that selects the shortest form of the floating point
+ *           value
+ *  \details printed digits read back to exactly the same value. exponent
+ *           form is used when the decimal point is more than 21 digits
+ *           after or 6 digits before the first digit */
+#define PRINT_SHORTEST UINT32_MAX
+
+/** \brief maximum precision of the floating point value */
+#ifndef PRINT_FLOAT_PRECISION
+  #define PRINT_FLOAT_PRECISION 40
+#endif
+
 /** \} */
 
+/** \brief   destination of the text
+ *  \details print writes the text straight to the sink, sink accepts as much
+ *           as it has space for */
+class i_print_sink
+{ public:
+    /** \brief write the piece of the text
+     *
+     *  \param data pointer to the characters
+     *  \param len  number of the characters
+     *
+     *  \return number of the accepted characters, less than len if the sink
+     *          is full */
+    virtual uint32_t write(const char* data, uint32_t len) = 0; };
+
+/** \brief base of the format strings made by PRINT_FMT */
+class print_format {};
+
+/** \brief   format string literal for print::fmt()
+ *  \details the literal is kept in the type, so the format is parsed and
+ *           checked against the arguments at compile time
+ *
+ *  \param text string literal */
+#define PRINT_FMT(text)                                             \
+  []                                                                \
+  { class print_format_text : public print_format                  \
+    { public:                                                       \
+        static constexpr const char* str() { return text; } };      \
+    return print_format_text(); }()
+
+/** \brief   conversion of the format string
+ *  \details conversion is '%', flags '-' (left alignment), '+' (explicit
+ *           plus), '0' (zero filler), '\'' (separators), width, '.' and
+ *           precision, then type: d, i, u, x, X, o, b, f, g, s, c or %.
+ *           literal text before the conversion is kept as range */
+class print_spec
+{ public:
+    constexpr print_spec()
+      : from(0),
+        to(0),
+        type(0),
+        left(false),
+        plus(false),
+        zero(false),
+        group(false),
+        width(0),
+        prec(UINT32_MAX)
+    {}
+
+    /** \brief start of the literal text before the conversion */
+    uint32_t from;
+
+    /** \brief end of the literal text before the conversion */
+    uint32_t to;
+
+    /** \brief type of the conversion, 0 after the last one */
+    char type;
+
+    /** \brief left alignment, right one is default like in printf */
+    bool left;
+
+    /** \brief explicit plus */
+    bool plus;
+
+    /** \brief zero filler, never set together with left */
+    bool zero;
+
+    /** \brief digits are separated */
+    bool group;
+
+    /** \brief length of space for the value */
+    uint32_t width;
+
+    /** \brief precision of the floating point value, UINT32_MAX if it's
+     *         not given */
+    uint32_t prec; };
+
+/** \brief   parse the conversion of the format string
+ *
+ *  \param str format string
+ *  \param n   index of the conversion, the text after the last conversion
+ *             has type 0
+ *
+ *  \return conversion */
+constexpr print_spec print_format_parse(const char* str, uint32_t n)
+{ uint32_t pos = 0;
+
+  for (uint32_t i = 0; ; i++)
+  { print_spec spec;
+    spec.from = pos;
+
+    while (str[pos] && str[pos] != '%') { pos++; }
+
+    spec.to = pos;
+
+    if (!str[pos]) { return spec; }
+
+    pos++;
+
+    for (; ; pos++)
+    { if (str[pos] == '-') { spec.left = true; }
+      else if (str[pos] == '+') { spec.plus = true; }
+      else if (str[pos] == '0') { spec.zero = true; }
+      else if (str[pos] == '\'') { spec.group = true; }
+      else { break; } }
+
+    // zeros can't follow the value, '-' cancels '0' like in printf
+    if (spec.left) { spec.zero = false; }
+
+    for (; str[pos] >= '0' && str[pos] <= '9'; pos++)
+    { spec.width = spec.width * 10 + (str[pos] - '0'); }
+
+    if (str[pos] == '.')
+    { spec.prec = 0;
+
+      for (pos++; str[pos] >= '0' && str[pos] <= '9'; pos++)
+      { spec.prec = spec.prec * 10 + (str[pos] - '0'); } }
+
+    // unknown or missing type is reported by print::fmt()
+    spec.type = (str[pos]) ? str[pos] : '?';
+
+    if (str[pos]) { pos++; }
+
+    if (i == n) { return spec; } } }
+
+/** \brief number of the conversions of the format string, %% included */
+constexpr uint32_t print_format_count(const char* str)
+{ uint32_t n = 0;
+
+  while (print_format_parse(str, n).type) { n++; }
+
+  return n; }
+
+/** \brief number of the arguments used by the conversions before n */
+constexpr uint32_t print_format_args(const char* str, uint32_t n)
+{ uint32_t args = 0;
+
+  for (uint32_t i = 0; i < n; i++)
+  { args += (print_format_parse(str, i).type != '%'); }
+
+  return args; }
+
+/** \brief argument of the parameter pack by index */
+template <uint32_t N, typename FIRST, typename... REST>
+constexpr const auto& print_format_arg(const FIRST& first,
+                                       const REST&... rest)
+{ if constexpr (N == 0) { return first; }
+  else { return print_format_arg<N - 1>(rest...); } }
+
+/** \brief   compile time check of the argument against the conversion
+ *  \details wrong types, flags and unknown conversions don't compile
+ *
+ *  \tparam FORMAT format string made by PRINT_FMT
+ *  \tparam I      index of the conversion
+ *  \tparam VALUE  type of the argument */
+template <typename FORMAT, uint32_t I, typename VALUE>
+constexpr void print_format_check()
+{ constexpr print_spec spec = print_format_parse(FORMAT::str(), I);
+  constexpr char type = spec.type;
+  using TYPE = typename std::decay<VALUE>::type;
+  constexpr bool integer = std::is_integral<TYPE>::value &&
+                           !std::is_same<TYPE, bool>::value;
+  constexpr bool number = type == 'd' || type == 'i' || type == 'f' ||
+                          type == 'g';
+  static_assert(!spec.plus || number, "'+' needs signed conversion");
+  static_assert(!spec.zero || !number, "'0' needs unsigned conversion");
+  static_assert(type == 'f' || spec.prec == UINT32_MAX,
+                "precision needs %f");
+
+  if constexpr (type == 'd' || type == 'i')
+  { static_assert(integer && std::is_signed<TYPE>::value,
+                  "%d needs signed integer"); }
+  else if constexpr (type == 'u' || type == 'o' || type == 'b')
+  { static_assert(integer && std::is_unsigned<TYPE>::value,
+                  "%u, %o and %b need unsigned integer"); }
+  else if constexpr (type == 'x' || type == 'X')
+  { static_assert(integer && std::is_unsigned<TYPE>::value,
+                  "%x needs unsigned integer");
+    static_assert(!spec.zero || spec.width <= 16, "%x has up to 16 digits");
+    static_assert(!spec.zero || type == 'x', "%X has no leading zeros"); }
+  else if constexpr (type == 'f' || type == 'g')
+  { static_assert(std::is_same<TYPE, float>::value ||
+                  std::is_same<TYPE, double>::value,
+                  "%f needs float or double");
+    static_assert(spec.prec <= PRINT_FLOAT_PRECISION ||
+                  spec.prec == UINT32_MAX, "precision is too large"); }
+  else if constexpr (type == 's')
+  { static_assert(std::is_same<TYPE, const char*>::value ||
+                  std::is_same<TYPE, char*>::value, "%s needs c-string"); }
+  else if constexpr (type == 'c')
+  { static_assert(std::is_same<TYPE, char>::value, "%c needs char"); }
+  else { static_assert(type == 'c', "unknown conversion"); } }
+
 /** \brief tool to formatted print to service interface or to buffer */
 class print
 { public:
@@ -44,11 +265,31 @@ class print
      *  \param size   maximum available space to print */
     print(char* buffer, uint32_t size);
 
-    /** \brief generic constructor for printing to dsp console */
+    /** \brief   generic constructor for printing to dsp console
+     *  \warning not for interrupts, the line buffer isn't protected */
     print();
 
+    /** \brief   constructor for printing to the sink
+     *  \details when the sink is full errcode is set to ERR_BUSY and the rest
+     *           of the statement is dropped. the same statement printed again
+     *           with skip equal to printed() continues from the first
+     *           character that wasn't accepted
+     *  \warning the statement is printed again from the start and the first
+     *           skip characters are thrown away, so the retry must have the
+     *           same format and the same values of the arguments. keep the
+     *           values until the statement is done, new values would glue
+     *           the tail of another text to the sent head
+     *
+     *  \param sink destination of the text
+     *  \param skip number of the first characters that are not written */
+    explicit print(i_print_sink& sink, uint32_t skip = 0);
+
+    /** \brief console output is flushed at destruction */
+    ~print();
+
     /** \brief   flush output buffer of dsp console
-     *  \details doesn't work in buffered mode */
+     *  \details sends the line buffer and calls bsp_tx_flush(). doesn't work
+     *           in buffered mode */
     print& flush();
 
     /** \brief in case of printing in buffer automatically terminates printed
@@ -111,7 +352,9 @@ class print
              uint8_t align = STD_ALIGN,
              char spc = STD_SPACER);
 
-    /** \brief print unsigned integer
+    /** \brief   print unsigned integer
+     *  \details digits are counted first and produced by pairs, values that
+     *           fit 32 bits don't use 64 bit divisions
      *
      *  \param uint         value to be printed
      *  \param separate_num number characters between separator spaces
@@ -121,7 +364,7 @@ class print
      *  \param spc          free space filler
      *
      *  \return reference to the printing object */
-    print& u(uint32_t uint,
+    print& u(uint64_t uint,
              uint32_t len = PRINT_NO_LIMITS,
              uint8_t separate_num = 0,
              uint8_t align = STD_ALIGN,
@@ -131,7 +374,8 @@ class print
      *  \details lowercase variant
      *
      *  \param uint         value to be printed
-     *  \param digits       number of digits to print
+     *  \param digits       minimum number of digits, leading zeros are added,
+     *                      up to 16
      *  \param len          length of space for the value sting
      *  \param separate_num number of characters between separator spaces
      *                      \note 0 if you don't need any separator
@@ -139,8 +383,8 @@ class print
      *  \param spc          free space filler
      *
      *  \return reference to the printing object */
-    print& x(uint32_t uint,
-             uint8_t digits = 32,
+    print& x(uint64_t uint,
+             uint8_t digits = 0,
              uint32_t len = PRINT_NO_LIMITS,
              uint8_t separate_num = 0,
              uint8_t align = STD_ALIGN,
@@ -157,7 +401,7 @@ class print
      *  \param spc          free space filler
      *
      *  \return reference to the printing object */
-    print& X(uint32_t uint,
+    print& X(uint64_t uint,
              uint32_t len = PRINT_NO_LIMITS,
              uint8_t separate_num = 0,
              uint8_t align = STD_ALIGN,
@@ -173,7 +417,7 @@ class print
      *  \param spc          free space filler
      *
      *  \return reference to the printing object */
-    print& o(uint32_t uint,
+    print& o(uint64_t uint,
              uint32_t len = PRINT_NO_LIMITS,
              uint8_t separate_num = 0,
              uint8_t align = STD_ALIGN,
@@ -188,7 +432,7 @@ class print
      *  \param spc          free space filler
      *
      *  \return reference to the printing object */
-    print& b(uint32_t uint,
+    print& b(uint64_t uint,
              uint32_t len = PRINT_NO_LIMITS,
              uint8_t separate_num = 0,
              uint8_t align = STD_ALIGN,
@@ -204,19 +448,28 @@ class print
      *  \param spc          free space filler
      *
      *  \return reference to the printing object */
-    print& i(int32_t sint,
+    print& i(int64_t sint,
              uint32_t len = PRINT_NO_LIMITS,
              uint8_t separate_num = 0,
              bool print_plus = false,
              uint8_t align = STD_ALIGN,
              char spc = STD_SPACER);
 
-    /** \brief print floating point value
+    /** \brief   print floating point value
+     *  \details digits are exact, the last one is rounded half to even like
+     *           printf does. only integer arithmetic is used, nan and
+     *           infinity are printed as "nan", "inf" and "-inf". fixed form
+     *           of the value below 2^64 with up to 60 fraction bits is made
+     *           on the stack. shortest form and the rest use static big
+     *           integers, such calls are not reentrant and shall not be made
+     *           from the interrupt while other context prints the float
      *
      *  \param flt          floating point value
-     *  \param prec         precision, volume of numbers after floating point
+     *  \param prec         precision, volume of numbers after floating point,
+     *                      up to PRINT_FLOAT_PRECISION or PRINT_SHORTEST
      *  \param len          length of space for the value string
      *  \param separate_num number of characters between separator spaces
+     *                      of the integer part
      *  \param print_plus   turn on explicit plus
      *  \param align        alignment inside printing space
      *  \param spc          free space filler
@@ -230,6 +483,97 @@ class print
              uint8_t align = STD_ALIGN,
              char spc = STD_SPACER);
 
+    /** \brief   print double precision floating point value
+     *  \details same as the float version, shortest form has more digits.
+     *           it's not reentrant either, unless fixed form of the value
+     *           below 2^64 with up to 60 fraction bits is printed
+     *
+     *  \param flt          floating point value
+     *  \param prec         precision, volume of numbers after floating point,
+     *                      up to PRINT_FLOAT_PRECISION or PRINT_SHORTEST
+     *  \param len          length of space for the value string
+     *  \param separate_num number of characters between separator spaces
+     *                      of the integer part
+     *  \param print_plus   turn on explicit plus
+     *  \param align        alignment inside printing space
+     *  \param spc          free space filler
+     *
+     *  \return reference to the printing object */
+    print& f(double flt,
+             uint32_t prec = STD_PRECISION_DIGITS,
+             uint32_t len = PRINT_NO_LIMITS,
+             uint8_t separate_num = 0,
+             bool print_plus = false,
+             uint8_t align = STD_ALIGN,
+             char spc = STD_SPACER);
+
+    /** \brief   print formatted by the format string
+     *  \details format is parsed at compile time and expanded into calls of
+     *           the printing methods, so nothing is parsed at runtime. wrong
+     *           number or types of the arguments don't compile. width is the
+     *           minimum and aligns right like in printf, longer values are
+     *           printed in full. '0' sets leading zeros of x and X and
+     *           zero filler of u, o and b. %f has STD_PRECISION_DIGITS by
+     *           default, %g is the shortest form
+     *
+     *  \code
+     *  print().fmt(PRINT_FMT("adc %u: %8.3f V\n"), channel, volts);
+     *  \endcode
+     *
+     *  \param format format string made by PRINT_FMT
+     *  \param args   values to be printed
+     *
+     *  \return reference to the printing object */
+    template <typename FORMAT, typename... ARGS>
+    print& fmt(FORMAT format, const ARGS&... args)
+    { static_assert(std::is_base_of<print_format, FORMAT>::value,
+                    "format string must be made by PRINT_FMT");
+      constexpr uint32_t count = print_format_count(FORMAT::str());
+      static_assert(print_format_args(FORMAT::str(), count) ==
+                    sizeof...(ARGS),
+                    "number of the arguments doesn't match the format");
+      (void)format;
+      stretch = true;
+      fmt_all<FORMAT>(std::make_integer_sequence<uint32_t, count + 1>(),
+                      args...);
+      stretch = false;
+      return *this; }
+
+    /** \brief   print the integer by the conversion parsed at runtime
+     *  \details widths are minimums like in fmt(), it's used for the values
+     *           that come with their format, like dlog records. the value
+     *           of %d and %i is the signed one in two's complement
+     *
+     *  \param spec conversion: d, i, u, x, X, o, b or c
+     *  \param raw  value
+     *
+     *  \return reference to the printing object */
+    print& value(const print_spec& spec, uint64_t raw);
+
+    /** \brief print the float by the conversion parsed at runtime
+     *
+     *  \param spec conversion: f or g
+     *  \param flt  value
+     *
+     *  \return reference to the printing object */
+    print& value(const print_spec& spec, float flt);
+
+    /** \brief print the double by the conversion parsed at runtime
+     *
+     *  \param spec conversion: f or g
+     *  \param flt  value
+     *
+     *  \return reference to the printing object */
+    print& value(const print_spec& spec, double flt);
+
+    /** \brief print the string by the conversion parsed at runtime
+     *
+     *  \param spec conversion: s
+     *  \param str  value
+     *
+     *  \return reference to the printing object */
+    print& value(const print_spec& spec, const char* str);
+
     /** \brief   print pointer
      *  \details print memory address in hex between '<' and '>' characters
      *  \warning result size is machine dependent
@@ -247,11 +591,25 @@ class print
      *  \note  main purpose of using it is printing in buffer */
     print& t();
 
+    /** \brief   number of the printed characters
+     *  \details skipped characters are counted too
+     *
+     *  \return number of the characters */
+    uint32_t printed() const { return counter; }
+
     /** \brief last error code
      *  \param if this variable would be not equal ERR_OK, the execution would
      *         be canceled */
     uint8_t errcode;
 
+    /** \brief   console waits for the space
+     *  \details if it's false the line that doesn't fit bsp_tx_available()
+     *           is dropped, so the superloop is never stalled by the console */
+    static bool blocking;
+
+    /** \brief number of the characters dropped by non-blocking console */
+    static uint32_t dropped;
+
   private:
     /** \brief pointer to the buffer that used to print */
     char* buffer;
@@ -262,6 +620,17 @@ class print
     /** \brief current position inside buffer */
     uint32_t counter;
 
+    /** \brief destination of the text, nullptr if it's not used */
+    i_print_sink* sink;
+
+    /** \brief number of the first characters that are not written to the
+     *         sink */
+    uint32_t skip;
+
+    /** \brief   length of space is the minimum one
+     *  \details set by fmt(), values that don't fit are not cut */
+    bool stretch;
+
     /** \brief actually prints the string
      *  \note all other methods are just wrappers for your comfort
      *
@@ -274,6 +643,123 @@ class print
                       uint8_t align,
                       char spc);
 
+    /** \brief prints the string of known length
+     *
+     *  \param str        pointer to string
+     *  \param actual_len length of the string
+     *  \param len        length of space for the string
+     *  \param align      alignment inside printing space
+     *  \param spc        free space filler */
+    void put(const char* str,
+             uint32_t actual_len,
+             uint32_t len,
+             uint8_t align,
+             char spc);
+
+    /** \brief   prints the digits of the number
+     *  \details separators are inserted while the digits are copied
+     *
+     *  \param digits       pointer to the digits
+     *  \param count        number of the digits
+     *  \param sign         sign character, 0 for none
+     *  \param separate_num number of characters between separator spaces
+     *  \param len          length of space for the value string
+     *  \param align        alignment inside printing space
+     *  \param spc          free space filler */
+    void number(const char* digits,
+                uint32_t count,
+                char sign,
+                uint8_t separate_num,
+                uint32_t len,
+                uint8_t align,
+                char spc);
+
+    /** \brief prints finite floating point value m * 2^e
+     *
+     *  \param m            mantissa with the hidden bit
+     *  \param e            binary exponent
+     *  \param bits         precision of the type in bits
+     *  \param sign         sign character, 0 for none
+     *  \param prec         number of the fraction digits or PRINT_SHORTEST
+     *  \param separate_num number of characters between separator spaces
+     *  \param len          length of space for the value string
+     *  \param align        alignment inside printing space
+     *  \param spc          free space filler */
+    void real(uint64_t m,
+              int32_t e,
+              uint32_t bits,
+              char sign,
+              uint32_t prec,
+              uint8_t separate_num,
+              uint32_t len,
+              uint8_t align,
+              char spc);
+
+    /** \brief print all of the conversions of the format and the text
+     *         after them */
+    template <typename FORMAT, uint32_t... I, typename... ARGS>
+    void fmt_all(std::integer_sequence<uint32_t, I...>, const ARGS&... args)
+    { (fmt_spec<FORMAT, I>(args...), ...); }
+
+    /** \brief print the conversion of the format and the text before it */
+    template <typename FORMAT, uint32_t I, typename... ARGS>
+    void fmt_spec(const ARGS&... args)
+    { constexpr print_spec spec = print_format_parse(FORMAT::str(), I);
+
+      if (errcode) { return; }
+
+      if constexpr (spec.to > spec.from)
+      { tx(FORMAT::str() + spec.from, spec.to - spec.from); }
+
+      if constexpr (spec.type == '%') { tx('%'); }
+      else if constexpr (spec.type != 0)
+      { constexpr uint32_t arg = print_format_args(FORMAT::str(), I);
+        fmt_arg<FORMAT, I>(print_format_arg<arg>(args...)); } }
+
+    /** \brief print the argument by the conversion of the format */
+    template <typename FORMAT, uint32_t I, typename VALUE>
+    void fmt_arg(const VALUE& value)
+    { constexpr print_spec spec = print_format_parse(FORMAT::str(), I);
+      constexpr char type = spec.type;
+      constexpr uint8_t align = (spec.left) ? ALIGN_LEFT : ALIGN_RIGHT;
+      constexpr uint8_t sep = (!spec.group) ? 0 :
+                              (type == 'x' || type == 'X' || type == 'b') ?
+                              4 : 3;
+      print_format_check<FORMAT, I, VALUE>();
+
+      if constexpr (type == 'd' || type == 'i')
+      { i(value, spec.width, sep, spec.plus, align); }
+      else if constexpr (type == 'u' || type == 'o' || type == 'b')
+      { constexpr char spc = (spec.zero) ? '0' : ' ';
+
+        if constexpr (type == 'u') { u(value, spec.width, sep, align, spc); }
+        else if constexpr (type == 'o')
+        { o(value, spec.width, sep, align, spc); }
+        else { b(value, spec.width, sep, align, spc); } }
+      else if constexpr (type == 'X') { X(value, spec.width, sep, align); }
+      else if constexpr (type == 'x' && spec.zero)
+      { x(value, spec.width, 0, sep); }
+      else if constexpr (type == 'x') { x(value, 0, spec.width, sep, align); }
+      else if constexpr (type == 'f' || type == 'g')
+      { constexpr uint32_t prec = (type == 'g') ? PRINT_SHORTEST :
+                                  (spec.prec == UINT32_MAX) ?
+                                  STD_PRECISION_DIGITS : spec.prec;
+        f(value, prec, spec.width, sep, spec.plus, align); }
+      else if constexpr (type == 's') { s(value, spec.width, align); }
+      else { put(&value, 1, spec.width, align, STD_SPACER); } }
+
+    /** \brief writes several characters at once
+     *
+     *  \param str pointer to the characters
+     *  \param n   number of the characters */
+    void tx(const char* str, uint32_t n);
+
+    /** \brief writes several characters to the sink
+     *
+     *  \param str pointer to the characters
+     *  \param n   number of the characters */
+    void tx_sink(const char* str, uint32_t n);
+
     /** \brief combines routines to write in buffer and bsp console
      *
      *  \param ch char to be txed or written in buffer */
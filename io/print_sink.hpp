@@ -0,0 +1,66 @@
+/** \file print_sink.hpp
+ *  \brief sinks of print for the pipes and the circular buffers */
+
+#ifndef PRINT_SINK_HPP
+#define PRINT_SINK_HPP
+
+#include <cstdint>
+#include "containers/circular_buffer.hpp"
+#include "core/pipe.hpp"
+#include "io/print.hpp"
+
+/** \brief   text goes straight to the pipe
+ *
+ *  \code
+ *  print_pipe_sink sink(p);
+ *  print(sink).fmt(PRINT_FMT("adc %u: %.3f V\n"), channel, volts);
+ *  \endcode */
+class print_pipe_sink : public i_print_sink
+{ public:
+    /** \brief constructor
+     *
+     *  \param p pipe to write to */
+    explicit print_pipe_sink(i_pipe& p) : p(p) {}
+
+    /** \brief write the piece of the text to the pipe
+     *
+     *  \param data pointer to the characters
+     *  \param len  number of the characters
+     *
+     *  \return number of the written characters */
+    virtual uint32_t write(const char* data, uint32_t len) override
+    { return p.write((void*)data, len); }
+
+    /** \brief destination pipe */
+    i_pipe& p; };
+
+/** \brief text goes straight to the circular buffer
+ *
+ *  \tparam VOLUME size of the circular buffer */
+template <uint32_t VOLUME>
+class print_circular_sink : public i_print_sink
+{ public:
+    /** \brief constructor
+     *
+     *  \param buf circular buffer to write to */
+    explicit print_circular_sink(circular_buffer<char, VOLUME>& buf)
+      : buf(buf)
+    {}
+
+    /** \brief write the piece of the text to the head of the buffer
+     *
+     *  \param data pointer to the characters
+     *  \param len  number of the characters
+     *
+     *  \return number of the written characters */
+    virtual uint32_t write(const char* data, uint32_t len) override
+    { uint32_t written = 0;
+
+      while (written < len && buf.push_head(data[written])) { written++; }
+
+      return written; }
+
+    /** \brief destination buffer */
+    circular_buffer<char, VOLUME>& buf; };
+
+#endif // PRINT_SINK_HPP
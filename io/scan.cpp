@@ -0,0 +1,432 @@
+/** \file scan.cpp
+ *  \brief implementation of reading of the values from the text */
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include "core/errcode.hpp"
+#include "io/scan.hpp"
+
+/** \brief exact powers of 10 for double */
+static const double pow10_double[23] =
+{ 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+  1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+/** \brief exact powers of 10 for float */
+static const float pow10_float[11] =
+{ 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+/** \brief check the decimal digit */
+static inline bool digit(char ch) { return (uint8_t)(ch - '0') < 10; }
+
+/** \brief values of the hexadecimal digits, 16 for other characters */
+class scan_hex_table
+{ public:
+    constexpr scan_hex_table() : value()
+    { for (uint32_t i = 0; i < 256; i++)
+      { value[i] = (i >= '0' && i <= '9') ? i - '0' :
+                   (i >= 'a' && i <= 'f') ? i - 'a' + 10 :
+                   (i >= 'A' && i <= 'F') ? i - 'A' + 10 : 16; } }
+
+    uint8_t value[256]; };
+
+/** \brief table of the hexadecimal digits */
+static constexpr scan_hex_table hex_table;
+
+/** \brief value of the hexadecimal digit
+ *
+ *  \return value or 16 if it's not a digit */
+static inline uint32_t hex_digit(char ch)
+{ return hex_table.value[(uint8_t)ch]; }
+
+/** \brief load eight characters, first one in the lowest byte */
+static inline uint64_t load_eight(const char* str)
+{ uint64_t val;
+  memcpy(&val, str, sizeof(val));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  val = __builtin_bswap64(val);
+#endif
+  return val; }
+
+/** \brief check that all of the eight characters are decimal digits */
+static inline bool eight_digits(uint64_t val)
+{ return (((val & 0xF0F0F0F0F0F0F0F0ULL) |
+           (((val + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+          0x3333333333333333ULL); }
+
+/** \brief   value of the eight decimal digits
+ *  \details pairs, then quads, then all eight digits are combined by three
+ *           multiplications
+ *
+ *  \param val values of the digits, first one in the lowest byte */
+static inline uint32_t eight_value(uint64_t val)
+{ const uint64_t mask = 0x000000FF000000FFULL;
+  const uint64_t mul1 = 100 + (1000000ULL << 32);
+  const uint64_t mul2 = 1 + (10000ULL << 32);
+  val = (val * 10) + (val >> 8);
+  val = (((val & mask) * mul1) + (((val >> 16) & mask) * mul2)) >> 32;
+  return (uint32_t)val; }
+
+/** \brief powers of 10 for the pieces of the digits */
+static const uint32_t pow10_piece[9] =
+{ 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+/** \brief   read decimal digits
+ *  \details up to eight digits are read at once: high bits of the bytes
+ *           mark the characters that are not digits, the digits are moved
+ *           to the high bytes and combined by eight_value()
+ *
+ *  \param str pointer to the digits, moved after them
+ *  \param end end of the text
+ *  \param val result
+ *
+ *  \return false if the value doesn't fit 64 bits */
+static inline bool decimal(const char*& str, const char* end, uint64_t& val)
+{ const char* s = str;
+
+  while (s < end && *s == '0') { s++; }
+
+  const char* first = s;
+  uint64_t v = 0;
+
+  // 19 digits at most, so there is no overflow
+  while (end - s >= 8)
+  { uint64_t chunk = load_eight(s) ^ 0x3030303030303030ULL;
+    uint64_t other = (((chunk & 0x7F7F7F7F7F7F7F7FULL) +
+                       0x7676767676767676ULL) | chunk) &
+                     0x8080808080808080ULL;
+    uint32_t n = (other) ? (uint32_t)__builtin_ctzll(other) / 8 : 8;
+
+    if (!n || s - first + n > 19) { break; }
+
+    v = v * pow10_piece[n] + eight_value(chunk << (8 * (8 - n)));
+    s += n;
+
+    if (n < 8)
+    { str = s;
+      val = v;
+      return true; } }
+
+  while (s < end && digit(*s) && s - first < 19)
+  { v = v * 10 + (uint64_t)(*s - '0');
+    s++; }
+
+  bool fits = true;
+
+  while (s < end && digit(*s))
+  { fits = fits && !__builtin_mul_overflow(v, 10, &v) &&
+           !__builtin_add_overflow(v, (uint64_t)(*s - '0'), &v);
+    s++; }
+
+  str = s;
+  val = v;
+  return fits; }
+
+scan::scan(const char* buffer, uint32_t size)
+  : errcode(ERR_OK),
+    data(buffer),
+    size(size),
+    pos(0),
+    consumed(0),
+    p(nullptr)
+{ }
+
+scan::scan(i_pipe& p)
+  : errcode(ERR_OK),
+    data(window),
+    size(0),
+    pos(0),
+    consumed(0),
+    p(&p)
+{ }
+
+void scan::fill()
+{ if (!p || size - pos >= SCAN_WINDOW_SIZE / 2) { return; }
+
+  memmove(window, window + pos, size - pos);
+  consumed += pos;
+  size -= pos;
+  pos = 0;
+  size += p->read(window + size, SCAN_WINDOW_SIZE - size); }
+
+bool scan::start()
+{ if (errcode) { return false; }
+
+  if (p) { fill(); }
+
+  while (pos < size && (data[pos] == ' ' || data[pos] == '\t'))
+  { pos++;
+
+    if (p) { fill(); } }
+
+  if (pos < size) { return true; }
+
+  errcode = (p) ? ERR_NOT_READY : ERR_BUFFER_OVERRUN;
+  return false; }
+
+bool scan::fail(uint8_t err, uint32_t at)
+{ errcode = err;
+  pos = at;
+  return false; }
+
+bool scan::end()
+{ fill();
+  return pos == size; }
+
+bool scan::unsigned_value(uint64_t& val, uint64_t max, bool radix)
+{ if (!start()) { return false; }
+
+  uint32_t at = pos;
+  const char* s = data + pos;
+  const char* first = s;
+  uint64_t v = 0;
+  bool fits = true;
+
+  if (radix)
+  { uint32_t d;
+
+    while (s < data + size && (d = hex_digit(*s)) < 16)
+    { fits = fits && !(v >> 60);
+      v = (v << 4) | d;
+      s++; } }
+  else { fits = decimal(s, data + size, v); }
+
+  if (s == first) { return fail(ERR_INVALID_DATA, at); }
+
+  if (!fits || v > max) { return fail(ERR_OUT_OF_RANGE, at); }
+
+  pos = (uint32_t)(s - data);
+  val = v;
+  return true; }
+
+bool scan::signed_value(int64_t& val, int64_t max)
+{ if (!start()) { return false; }
+
+  uint32_t at = pos;
+  const char* s = data + pos;
+  bool minus = *s == '-';
+
+  if (minus || *s == '+') { s++; }
+
+  const char* first = s;
+  uint64_t v;
+  bool fits = decimal(s, data + size, v);
+
+  if (s == first) { return fail(ERR_INVALID_DATA, at); }
+
+  if (!fits || v > (uint64_t)max + minus)
+  { return fail(ERR_OUT_OF_RANGE, at); }
+
+  pos = (uint32_t)(s - data);
+  val = (minus) ? (int64_t)(0 - v) : (int64_t)v;
+  return true; }
+
+bool scan::real(double& dbl, float& flt, bool single)
+{ if (!start()) { return false; }
+
+  uint32_t at = pos;
+  const char* s = data + pos;
+  const char* end = data + size;
+  bool minus = *s == '-';
+
+  if (minus || *s == '+') { s++; }
+
+  if (end - s >= 3 && (!memcmp(s, "inf", 3) || !memcmp(s, "nan", 3)))
+  { double v = (*s == 'i') ? std::numeric_limits<double>::infinity() :
+               std::numeric_limits<double>::quiet_NaN();
+    dbl = (minus) ? -v : v;
+    flt = (float)dbl;
+    pos = (uint32_t)(s + 3 - data);
+    return true; }
+
+  // up to 19 significant digits are collected, the rest only moves the
+  // decimal point or makes the value inexact
+  uint64_t w = 0;
+  int32_t exp10 = 0;
+  uint32_t count = 0;
+  bool truncated = false;
+  const char* first = s;
+
+  while (s < end && *s == '0') { s++; }
+
+  while (end - s >= 8 && count + 8 <= 19 && eight_digits(load_eight(s)))
+  { w = w * 100000000 + eight_value(load_eight(s) - 0x3030303030303030ULL);
+    count += 8;
+    s += 8; }
+
+  for (; s < end && digit(*s); s++)
+  { if (count < 19) { w = w * 10 + (uint64_t)(*s - '0'); count++; }
+    else { exp10++; truncated = truncated || *s != '0'; } }
+
+  bool digits = s != first;
+
+  if (s < end && *s == '.')
+  { s++;
+    const char* fraction = s;
+
+    if (!count)
+    { while (s < end && *s == '0') { s++; exp10--; } }
+
+    while (end - s >= 8 && count + 8 <= 19 && eight_digits(load_eight(s)))
+    { w = w * 100000000 +
+          eight_value(load_eight(s) - 0x3030303030303030ULL);
+      count += 8;
+      exp10 -= 8;
+      s += 8; }
+
+    for (; s < end && digit(*s); s++)
+    { if (count < 19)
+      { w = w * 10 + (uint64_t)(*s - '0');
+        count++;
+        exp10--; }
+      else { truncated = truncated || *s != '0'; } }
+
+    digits = digits || s != fraction; }
+
+  if (!digits) { return fail(ERR_INVALID_DATA, at); }
+
+  // exponent without digits is not a part of the number
+  if (s < end && (*s == 'e' || *s == 'E'))
+  { const char* e = s + 1;
+    bool negative = e < end && *e == '-';
+
+    if (e < end && (*e == '-' || *e == '+')) { e++; }
+
+    if (e < end && digit(*e))
+    { int32_t value = 0;
+
+      for (; e < end && digit(*e); e++)
+      { if (value < 100000) { value = value * 10 + (*e - '0'); } }
+
+      exp10 += (negative) ? -value : value;
+      s = e; } }
+
+  if (!w)
+  { dbl = (minus) ? -0.0 : 0.0;
+    flt = (minus) ? -0.0f : 0.0f;
+    pos = (uint32_t)(s - data);
+    return true; }
+
+  // both the mantissa and the power are exact, so one rounding is done
+  if (!truncated && single && w <= (1u << 24) && exp10 >= -10 &&
+      exp10 <= 10)
+  { float v = (float)w;
+    v = (exp10 < 0) ? v / pow10_float[-exp10] : v * pow10_float[exp10];
+    flt = (minus) ? -v : v;
+    pos = (uint32_t)(s - data);
+    return true; }
+
+  if (!truncated && !single && w <= (1ULL << 53) && exp10 >= -22 &&
+      exp10 <= 22)
+  { double v = (double)w;
+    v = (exp10 < 0) ? v / pow10_double[-exp10] : v * pow10_double[exp10];
+    dbl = (minus) ? -v : v;
+    pos = (uint32_t)(s - data);
+    return true; }
+
+  // rare values are converted by libc from the copy
+  uint32_t len = (uint32_t)(s - (data + at));
+
+  if (len >= SCAN_FLOAT_SIZE) { return fail(ERR_BUFFER_OVERFLOW, at); }
+
+  char text[SCAN_FLOAT_SIZE];
+  memcpy(text, data + at, len);
+  text[len] = '\0';
+
+  if (single)
+  { float v = strtof(text, nullptr);
+
+    if (v == std::numeric_limits<float>::infinity() ||
+        v == -std::numeric_limits<float>::infinity())
+    { return fail(ERR_OUT_OF_RANGE, at); }
+
+    flt = v; }
+  else
+  { double v = strtod(text, nullptr);
+
+    if (v == std::numeric_limits<double>::infinity() ||
+        v == -std::numeric_limits<double>::infinity())
+    { return fail(ERR_OUT_OF_RANGE, at); }
+
+    dbl = v; }
+
+  pos = (uint32_t)(s - data);
+  return true; }
+
+scan& scan::f(float& val)
+{ double unused;
+  real(unused, val, true);
+  return *this; }
+
+scan& scan::f(double& val)
+{ float unused;
+  real(val, unused, false);
+  return *this; }
+
+scan& scan::operator()(char ch)
+{ if (errcode) { return *this; }
+
+  if (p) { fill(); }
+
+  if (pos == size) { errcode = (p) ? ERR_NOT_READY : ERR_BUFFER_OVERRUN; }
+  else if (data[pos] != ch) { errcode = ERR_INVALID_DATA; }
+  else { pos++; }
+
+  return *this; }
+
+scan& scan::operator()(const char* str)
+{ if (errcode) { return *this; }
+
+  fill();
+  uint32_t at = pos;
+
+  for (; *str; str++, pos++)
+  { if (pos == size)
+    { fail((p) ? ERR_NOT_READY : ERR_BUFFER_OVERRUN, at);
+      break; }
+
+    if (data[pos] != *str)
+    { fail(ERR_INVALID_DATA, at);
+      break; } }
+
+  return *this; }
+
+scan& scan::field(char* out, uint32_t len, char delim)
+{ if (errcode) { return *this; }
+
+  fill();
+  uint32_t at = pos;
+  uint32_t n = 0;
+
+  while (pos < size && data[pos] != delim && data[pos] != '\r' &&
+         data[pos] != '\n')
+  { pos++;
+    n++; }
+
+  if (n >= len)
+  { fail(ERR_BUFFER_OVERFLOW, at);
+    return *this; }
+
+  memcpy(out, data + at, n);
+  out[n] = '\0';
+
+  if (pos < size && data[pos] == delim) { pos++; }
+
+  return *this; }
+
+scan& scan::skip(char delim)
+{ if (errcode) { return *this; }
+
+  while (true)
+  { fill();
+
+    if (pos == size) { return *this; }
+
+    const char* hit = (const char*)memchr(data + pos, delim, size - pos);
+
+    if (hit)
+    { pos = (uint32_t)(hit - data) + 1;
+      return *this; }
+
+    pos = size; } }
@@ -0,0 +1,247 @@
+/** \file scan.hpp
+ *  \brief reading of the values from the text, counterpart of print */
+
+#ifndef SCAN_HPP
+#define SCAN_HPP
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "core/pipe.hpp"
+
+/** \defgroup scan_flags
+ *  \brief    settings of scan
+ *  \{ */
+
+/** \brief   size of the window of the pipe
+ *  \details values, texts and fields read from the pipe shall be shorter
+ *           than half of it */
+#ifndef SCAN_WINDOW_SIZE
+  #define SCAN_WINDOW_SIZE 128
+#endif
+
+/** \brief   maximum length of the floating point number that doesn't fit the
+ *           fast path
+ *  \details such numbers are copied to the stack and converted by strtod */
+#ifndef SCAN_FLOAT_SIZE
+  #define SCAN_FLOAT_SIZE 64
+#endif
+
+/** \} */
+
+/** \brief   tool to read the values from the text in buffer or in pipe
+ *  \details calls are chained like in print. spaces and tabs before the
+ *           numbers are skipped. if any call fails, errcode is set, the rest
+ *           of the chain does nothing and position() points to the first
+ *           character of the value that failed:
+ *           - ERR_INVALID_DATA    the text is not the expected one
+ *           - ERR_OUT_OF_RANGE    number doesn't fit the type
+ *           - ERR_BUFFER_OVERFLOW field doesn't fit the output or the
+ *                                 number is longer than SCAN_FLOAT_SIZE
+ *           - ERR_BUFFER_OVERRUN  end of the buffer
+ *           - ERR_NOT_READY       pipe is empty
+ *
+ *  \code
+ *  scan in(line, len);
+ *  in("$GPGGA,").field(time, sizeof(time), ',').f(lat)(',');
+ *  \endcode */
+class scan
+{ public:
+    /** \brief constructor for reading from buffer
+     *
+     *  \param buffer pointer to the text
+     *  \param size   size of the text */
+    scan(const char* buffer, uint32_t size);
+
+    /** \brief   constructor for reading from pipe
+     *  \details the text is read by pieces to the window of the object, read
+     *           characters are not returned to the pipe. the producer should
+     *           write whole lines, number at the end of the pipe is taken as
+     *           complete
+     *
+     *  \param p pipe */
+    explicit scan(i_pipe& p);
+
+    /** \brief read unsigned decimal integer
+     *
+     *  \tparam TYPE unsigned integer type
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the scanning object */
+    template <typename TYPE>
+    scan& u(TYPE& val)
+    { static_assert(std::is_integral<TYPE>::value &&
+                    std::is_unsigned<TYPE>::value,
+                    "u() needs unsigned integer");
+      uint64_t value;
+
+      if (unsigned_value(value, std::numeric_limits<TYPE>::max(), false))
+      { val = (TYPE)value; }
+
+      return *this; }
+
+    /** \brief read signed decimal integer
+     *
+     *  \tparam TYPE signed integer type
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the scanning object */
+    template <typename TYPE>
+    scan& i(TYPE& val)
+    { static_assert(std::is_integral<TYPE>::value &&
+                    std::is_signed<TYPE>::value, "i() needs signed integer");
+      int64_t value;
+
+      if (signed_value(value, std::numeric_limits<TYPE>::max()))
+      { val = (TYPE)value; }
+
+      return *this; }
+
+    /** \brief read hexadecimal integer without prefix, both cases of digits
+     *
+     *  \tparam TYPE unsigned integer type
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the scanning object */
+    template <typename TYPE>
+    scan& x(TYPE& val)
+    { static_assert(std::is_integral<TYPE>::value &&
+                    std::is_unsigned<TYPE>::value,
+                    "x() needs unsigned integer");
+      uint64_t value;
+
+      if (unsigned_value(value, std::numeric_limits<TYPE>::max(), true))
+      { val = (TYPE)value; }
+
+      return *this; }
+
+    /** \brief   read floating point number
+     *  \details digits, point and exponent like strtod, also "inf" and "nan"
+     *           as print makes them. result is rounded correctly
+     *
+     *  \param val reference to the variable
+     *
+     *  \return reference to the scanning object */
+    scan& f(float& val);
+
+    /** \brief   read floating point number
+     *  \details digits, point and exponent like strtod, also "inf" and "nan"
+     *           as print makes them. result is rounded correctly
+     *
+     *  \param val reference to the variable
+     *
+     *  \return reference to the scanning object */
+    scan& f(double& val);
+
+    /** \brief skip the expected character
+     *
+     *  \param ch character
+     *
+     *  \return reference to the scanning object */
+    scan& operator()(char ch);
+
+    /** \brief skip the expected text
+     *
+     *  \param str text
+     *
+     *  \return reference to the scanning object */
+    scan& operator()(const char* str);
+
+    /** \brief   read the text till the delimiter
+     *  \details field ends at the delimiter, at the end of the line or at the
+     *           end of the text. only the delimiter is skipped. field is
+     *           terminated by null, empty field is allowed
+     *
+     *  \param out   buffer for the field
+     *  \param len   size of the buffer
+     *  \param delim delimiter
+     *
+     *  \return reference to the scanning object */
+    scan& field(char* out, uint32_t len, char delim);
+
+    /** \brief   skip the text till the delimiter and the delimiter itself
+     *  \details skips to the end of the text if there is no delimiter
+     *
+     *  \param delim delimiter
+     *
+     *  \return reference to the scanning object */
+    scan& skip(char delim);
+
+    /** \brief number of the read characters
+     *
+     *  \return position in the text */
+    uint32_t position() const { return consumed + pos; }
+
+    /** \brief check if all of the text is read
+     *
+     *  \return true if there is nothing to read */
+    bool end();
+
+    /** \brief   last error code
+     *  \details if it's not ERR_OK, the rest of the calls do nothing */
+    uint8_t errcode;
+
+  private:
+    /** \brief text or the window of the pipe */
+    const char* data;
+
+    /** \brief size of the text */
+    uint32_t size;
+
+    /** \brief current position in the text */
+    uint32_t pos;
+
+    /** \brief number of the characters removed from the window */
+    uint32_t consumed;
+
+    /** \brief pipe, nullptr for buffer */
+    i_pipe* p;
+
+    /** \brief window of the pipe */
+    char window[SCAN_WINDOW_SIZE];
+
+    /** \brief   move the rest of the window to the start and read the pipe
+     *  \details window is filled only when less than half of it is left */
+    void fill();
+
+    /** \brief   prepare reading of the value
+     *  \details skips spaces and tabs, sets errcode at the end of the text
+     *
+     *  \return true if there is the text to read */
+    bool start();
+
+    /** \brief set errcode and return to the start of the value
+     *
+     *  \param err error code
+     *  \param at  position of the value
+     *
+     *  \return false */
+    bool fail(uint8_t err, uint32_t at);
+
+    /** \brief read unsigned integer
+     *
+     *  \param val   result
+     *  \param max   maximum value of the type
+     *  \param radix hexadecimal if true, decimal otherwise
+     *
+     *  \return true on success */
+    bool unsigned_value(uint64_t& val, uint64_t max, bool radix);
+
+    /** \brief read signed integer
+     *
+     *  \param val result
+     *  \param max maximum value of the type, minimum is -max - 1
+     *
+     *  \return true on success */
+    bool signed_value(int64_t& val, int64_t max);
+
+    /** \brief read floating point number
+     *
+     *  \param dbl    result for double
+     *  \param flt    result for float
+     *  \param single float is read
+     *
+     *  \return true on success */
+    bool real(double& dbl, float& flt, bool single); };
+
+#endif // SCAN_HPP
@@ -0,0 +1,67 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstring>
+#include "tools/crc.hpp"
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+
+/** \brief standard check string of the crc catalogue */
+const char* check = "123456789";
+
+TEST_GROUP(crc_tests)
+{ void setup() {}
+  void teardown() {} };
+
+TEST(crc_tests, crc8_check)
+{ CHECK(crc8::calc(check, strlen(check)) == 0xF4); }
+
+TEST(crc_tests, crc8_maxim_check)
+{ CHECK(crc8_maxim::calc(check, strlen(check)) == 0xA1); }
+
+TEST(crc_tests, crc16_ccitt_check)
+{ CHECK(crc16_ccitt::calc(check, strlen(check)) == 0x29B1); }
+
+TEST(crc_tests, crc16_xmodem_check)
+{ CHECK(crc16_xmodem::calc(check, strlen(check)) == 0x31C3); }
+
+TEST(crc_tests, crc16_modbus_check)
+{ CHECK(crc16_modbus::calc(check, strlen(check)) == 0x4B37); }
+
+TEST(crc_tests, crc32_check)
+{ CHECK(crc32::calc(check, strlen(check)) == 0xCBF43926); }
+
+TEST(crc_tests, incremental_equals_single_call)
+{ crc16_modbus sum;
+
+  for (uint32_t i = 0; i < strlen(check); i++) { sum.put((uint8_t)check[i]); }
+
+  CHECK(sum.get() == 0x4B37);
+  sum.reset().put(check, 4).put(check + 4, strlen(check) - 4);
+  CHECK(sum.get() == 0x4B37); }
+
+TEST(crc_tests, sliced_equals_bytewise)
+{ uint8_t data[1031];
+
+  for (uint32_t i = 0; i < sizeof(data); i++)
+  { data[i] = (uint8_t)(i * 7 + 3); }
+
+  uint32_t expected = crc32::calc(data, sizeof(data));
+  CHECK(crc32_s4::calc(data, sizeof(data)) == expected);
+  CHECK(crc32_s8::calc(data, sizeof(data)) == expected);
+  CHECK(crc32_s8::calc(check, strlen(check)) == 0xCBF43926);
+  CHECK((crc<uint16_t, 0x1021, 0xFFFF, false, 0x0000, 4>
+         ::calc(check, strlen(check)) == 0x29B1));
+  CHECK((crc<uint8_t, 0x07, 0x00, false, 0x00, 8>
+         ::calc(data, sizeof(data)) == crc8::calc(data, sizeof(data)))); }
+
+TEST(crc_tests, pipe_calculates_written_data)
+{ crc_pipe<crc32, 16> p;
+  CHECK(p.write((void*)check, strlen(check)) == strlen(check));
+  CHECK(p.sum.get() == 0xCBF43926); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
@@ -0,0 +1,200 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "io/dlog.hpp"
+#include "tools/dlog_decoder.hpp"
+#include "core/errcode.hpp"
+
+uint8_t console[DLOG_SIZE * 4];
+uint32_t console_used = 0;
+uint32_t space = UINT32_MAX;
+
+/** \brief number of the records that the console writes in the drop report */
+uint32_t write_in_report = 0;
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+void bsp_tx_char(char ch) { (void)ch; }
+
+void bsp_tx_block(const char* data, uint32_t len)
+{ memcpy(console + console_used, data, len);
+  console_used += len;
+  uint32_t id = 1;
+
+  // the report is sent in one piece, records may be split by the ring end
+  if (len == DLOG_HEADER + 4) { memcpy(&id, data + 1, sizeof(id)); }
+
+  if (!write_in_report || id != DLOG_DROPPED_ID) { return; }
+
+  // like the interrupt that comes while the report is sent
+  uint32_t n = write_in_report;
+  write_in_report = 0;
+
+  for (uint32_t i = 0; i < n; i++) { dlog::write(PRINT_FMT("%u"), i); } }
+
+uint32_t bsp_tx_available() { return space; }
+
+char text[512];
+uint8_t decode_errcode = ERR_OK;
+
+/** \brief image of the test itself is the firmware */
+std::vector<char> image;
+
+/** \brief decode the records by the string table of this test */
+static uint32_t decode(const uint8_t* data, uint32_t size)
+{ if (image.empty())
+  { std::ifstream f("/proc/self/exe", std::ios::binary);
+    image.assign(std::istreambuf_iterator<char>(f),
+                 std::istreambuf_iterator<char>()); }
+
+  memset(text, 0, sizeof(text));
+  static dlog_decoder decoder(image.data(), (uint32_t)image.size());
+  decoder.errcode = ERR_OK;
+  print out(text, sizeof(text));
+  uint32_t used = decoder.decode(data, size, out);
+  decode_errcode = decoder.errcode;
+  return used; }
+
+TEST_GROUP(dlog_tests)
+{ void setup()
+  { console_used = 0;
+    space = UINT32_MAX;
+    dlog::drain(); // leftovers of the previous test
+    console_used = 0; }
+
+  void teardown() {} };
+
+TEST(dlog_tests, record_is_raw)
+{ dlog::write(PRINT_FMT("value %u"), (uint16_t)0x1234);
+  CHECK(dlog::drain() == DLOG_HEADER + 2);
+  CHECK(console[0] == DLOG_HEADER + 2);
+  uint16_t value;
+  memcpy(&value, console + DLOG_HEADER, sizeof(value));
+  CHECK(value == 0x1234); }
+
+TEST(dlog_tests, id_is_known_at_compile_time)
+{ auto format = PRINT_FMT("%u");
+  using ENTRY = dlog_entry<decltype(format), uint32_t>;
+  static_assert(ENTRY::id == dlog_hash("I\0%u", 4), "hash of the entry");
+  STRCMP_EQUAL("%u", ENTRY::text.data + DLOG_MAGIC_SIZE + 2); }
+
+TEST(dlog_tests, decoded_on_host)
+{ dlog::write(PRINT_FMT("adc %u: %.3f V"), 3u, 1.25f);
+  dlog::write(PRINT_FMT("%d %x %5s|%c %g 100%%"), (int8_t)-5, 0xBEEFu,
+              "ok", 'z', 0.1);
+  dlog::write(PRINT_FMT("plain"));
+  uint32_t sent = dlog::drain();
+  CHECK(decode(console, sent) == sent);
+  CHECK(decode_errcode == ERR_OK);
+  STRCMP_EQUAL("adc 3: 1.250 V\n-5 beef    ok|z 0.1 100%\nplain\n", text); }
+
+TEST(dlog_tests, narrow_width_is_not_cut)
+{ dlog::write(PRINT_FMT("[%3u] [%2d] [%4x] [%-05u] [%1s] [%3.1f]"), 12345u,
+              -100, 0xABCDEFu, 42u, "long", 1234.5);
+  uint32_t sent = dlog::drain();
+  CHECK(decode(console, sent) == sent);
+  CHECK(decode_errcode == ERR_OK);
+  STRCMP_EQUAL("[12345] [-100] [abcdef] [42   ] [long] [1234.5]\n", text); }
+
+TEST(dlog_tests, long_string_is_clipped)
+{ char name[DLOG_STRING_MAX + 10];
+  memset(name, 'a', sizeof(name) - 1);
+  name[sizeof(name) - 1] = '\0';
+  dlog::write(PRINT_FMT("%s"), (const char*)name);
+  uint32_t sent = dlog::drain();
+  CHECK(sent == DLOG_HEADER + 1 + DLOG_STRING_MAX);
+  decode(console, sent);
+  CHECK(strlen(text) == DLOG_STRING_MAX + 1); }
+
+TEST(dlog_tests, drops_are_reported)
+{ uint32_t before = dlog::dropped;
+
+  for (uint32_t i = 0; i < DLOG_SIZE; i++)
+  { dlog::write(PRINT_FMT("%u"), i); }
+
+  CHECK(dlog::dropped > before);
+  uint32_t lost = dlog::dropped - before;
+  uint32_t kept = DLOG_SIZE / 9;
+  uint32_t sent = dlog::drain();
+  CHECK(sent == kept * 9 + DLOG_HEADER + 4);
+  uint32_t count;
+  memcpy(&count, console + kept * 9 + DLOG_HEADER, sizeof(count));
+  CHECK(count == lost);
+  decode(console + (kept - 1) * 9, 9 + DLOG_HEADER + 4);
+  char expected[64];
+  print(expected, sizeof(expected)).u(kept - 1)("\n<").u(lost)
+  (" records dropped>\n").t();
+  STRCMP_EQUAL(expected, text); }
+
+TEST(dlog_tests, report_follows_older_records)
+{ for (uint32_t i = 0; i < DLOG_SIZE; i++)
+  { dlog::write(PRINT_FMT("%u"), i); }
+
+  uint32_t kept = DLOG_SIZE / 9;
+  space = 18;
+  CHECK(dlog::drain() == 18);
+  space = UINT32_MAX;
+  dlog::write(PRINT_FMT("%u"), 777u);
+  console_used = 0;
+  uint32_t sent = dlog::drain();
+  CHECK(sent == (kept - 2) * 9 + DLOG_HEADER + 4 + 9);
+  decode(console + (kept - 3) * 9, 9 + DLOG_HEADER + 4 + 9);
+  char expected[64];
+  print(expected, sizeof(expected)).u(kept - 1)("\n<")
+  .u(DLOG_SIZE - kept)(" records dropped>\n777\n").t();
+  STRCMP_EQUAL(expected, text); }
+
+TEST(dlog_tests, drops_during_report_are_reported)
+{ uint32_t before = dlog::dropped;
+
+  for (uint32_t i = 0; i < DLOG_SIZE; i++)
+  { dlog::write(PRINT_FMT("%u"), i); }
+
+  uint32_t first = dlog::dropped - before;
+  write_in_report = DLOG_SIZE;
+  dlog::drain();
+  CHECK(write_in_report == 0);
+  uint32_t second = dlog::dropped - before - first;
+  CHECK(second > 0);
+  // the second report follows the records written during the first one
+  uint32_t last = 9 + DLOG_HEADER + 4;
+  CHECK(console_used > last);
+  decode(console + console_used - last, last);
+  char expected[64];
+  print(expected, sizeof(expected)).u(DLOG_SIZE / 9 - 1)("\n<").u(second)
+  (" records dropped>\n").t();
+  STRCMP_EQUAL(expected, text);
+  console_used = 0;
+  CHECK(dlog::drain() == 0); }
+
+TEST(dlog_tests, backpressure_of_pipe)
+{ pipe<20> p;
+  dlog::write(PRINT_FMT("%u"), 1u);
+  dlog::write(PRINT_FMT("%u"), 2u);
+  dlog::write(PRINT_FMT("%u"), 3u);
+  CHECK(dlog::drain(p) == 18);
+  uint8_t out[32];
+  uint32_t n = p.read(out, sizeof(out));
+  CHECK(n == 18);
+  CHECK(dlog::drain(p) == 9);
+  n += p.read(out + n, sizeof(out) - n);
+  decode(out, n);
+  STRCMP_EQUAL("1\n2\n3\n", text); }
+
+TEST(dlog_tests, incomplete_record_waits)
+{ dlog::write(PRINT_FMT("%u"), 7u);
+  space = 8;
+  CHECK(dlog::drain() == 0);
+  space = UINT32_MAX;
+  uint32_t sent = dlog::drain();
+  CHECK(decode(console, sent - 1) == 0);
+  CHECK(decode(console, sent) == sent); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
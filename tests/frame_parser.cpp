@@ -0,0 +1,145 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include "tools/frame_parser.hpp"
+#include "tools/crc.hpp"
+#include "core/errcode.hpp"
+#include <cstdint>
+#include <cstring>
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+
+typedef frame_parser<32,
+                     frame_bytes<0xAA, 0x55>,
+                     frame_field<1>,
+                     frame_length<uint8_t>,
+                     frame_payload,
+                     frame_crc<crc16_modbus, false>,
+                     frame_bytes<0x0D>> test_parser;
+
+typedef frame_parser<16,
+                     frame_bytes<'$'>,
+                     frame_until<'\r', '\n'>> line_parser;
+
+static test_parser parser;
+
+/** \brief make the frame of the test protocol
+ *
+ *  \param out  buffer for the frame
+ *  \param addr address field
+ *  \param data payload
+ *  \param size size of the payload
+ *
+ *  \return size of the frame */
+static uint32_t make(uint8_t* out, uint8_t addr, const uint8_t* data,
+                     uint8_t size)
+{ out[0] = 0xAA;
+  out[1] = 0x55;
+  out[2] = addr;
+  out[3] = size;
+  memcpy(out + 4, data, size);
+  uint16_t sum = crc16_modbus::calc(out + 2, size + 2);
+  out[4 + size] = (uint8_t)sum;
+  out[5 + size] = (uint8_t)(sum >> 8);
+  out[6 + size] = 0x0D;
+  return 7 + size; }
+
+/** \brief feed the bytes to the parser
+ *
+ *  \return number of complete frames */
+template <typename PARSER>
+static uint32_t feed(PARSER& p, const uint8_t* data, uint32_t size)
+{ uint32_t frames = 0;
+
+  for (uint32_t i = 0; i < size; i++)
+  { if (p.put(data[i])) { frames++; } }
+
+  return frames; }
+
+TEST_GROUP(frame_parser_unit_tests)
+{ void setup()
+  { parser.reset();
+    parser.errors = 0;
+    parser.timeout = 0; }
+
+  void teardown() {} };
+
+TEST(frame_parser_unit_tests, frame)
+{ uint8_t payload[] = { 0x12, 0x34, 0x56 };
+  uint8_t buffer[32];
+  uint32_t size = make(buffer, 0x07, payload, sizeof(payload));
+
+  for (uint32_t i = 0; i < size - 1; i++) { CHECK(!parser.put(buffer[i])); }
+
+  CHECK(parser.put(buffer[size - 1]));
+  CHECK(parser.data[2] == 0x07);
+  uint16_t value = 0;
+  deserializer in = parser.payload();
+  in.be<uint16_t>(value);
+  CHECK(value == 0x1234);
+  CHECK(in.buffer_size == 3);
+  CHECK(parser.frame().buffer_size == size); }
+
+TEST(frame_parser_unit_tests, garbage_between_frames)
+{ uint8_t payload[] = { 1, 2 };
+  uint8_t stream[64] = { 0x00, 0xAA, 0x13, 0xAA };
+  uint32_t size = 4;
+  size += make(stream + size, 1, payload, sizeof(payload));
+  stream[size++] = 0x55;
+  size += make(stream + size, 2, payload, sizeof(payload));
+  CHECK(feed(parser, stream, size) == 2);
+  CHECK(parser.data[2] == 2);
+  CHECK(parser.errors == 0); }
+
+TEST(frame_parser_unit_tests, wrong_checksum)
+{ uint8_t payload[] = { 1, 2, 3 };
+  uint8_t stream[64];
+  uint32_t size = make(stream, 1, payload, sizeof(payload));
+  stream[5] ^= 0x01;
+  size += make(stream + size, 2, payload, sizeof(payload));
+  CHECK(feed(parser, stream, size) == 1);
+  CHECK(parser.data[2] == 2);
+  CHECK(parser.errors == 1); }
+
+TEST(frame_parser_unit_tests, empty_payload)
+{ uint8_t stream[16];
+  uint32_t size = make(stream, 3, nullptr, 0);
+  CHECK(feed(parser, stream, size) == 1);
+  CHECK(parser.length == 0);
+  CHECK(parser.payload().buffer_size == 0); }
+
+TEST(frame_parser_unit_tests, too_long_payload)
+{ uint8_t stream[] = { 0xAA, 0x55, 0x01, 0xF0, 0xAA, 0x55 };
+  CHECK(feed(parser, stream, sizeof(stream)) == 0);
+  CHECK(parser.used == 2);
+  CHECK(parser.state == 1); }
+
+TEST(frame_parser_unit_tests, timeout)
+{ uint8_t payload[] = { 1, 2 };
+  uint8_t stream[16];
+  uint32_t size = make(stream, 1, payload, sizeof(payload));
+  parser.timeout = 10;
+  CHECK(!parser.put(stream[0], 100));
+  CHECK(!parser.put(stream[1], 105));
+  CHECK(!parser.put(stream[2], 120));
+  CHECK(parser.used == 0);
+  uint32_t frames = 0;
+
+  for (uint32_t i = 0; i < size; i++)
+  { if (parser.put(stream[i], 130 + i)) { frames++; } }
+
+  CHECK(frames == 1); }
+
+TEST(frame_parser_unit_tests, terminated_payload)
+{ line_parser lines;
+  const char* text = "x$12,ab\r\n$\r\n";
+  CHECK(feed(lines, (const uint8_t*)text, 9) == 1);
+  CHECK(lines.length == 5);
+  MEMCMP_EQUAL("12,ab", lines.data + lines.start, 5);
+  CHECK(feed(lines, (const uint8_t*)text + 9, 3) == 1);
+  CHECK(lines.length == 0); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
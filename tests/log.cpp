@@ -0,0 +1,105 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstring>
+#include "bsp/bsp.h"
+#include "core/errcode.hpp"
+#include "core/module.hpp"
+#include "io/log.hpp"
+
+char output_buffer[256] = { 0 };
+uint32_t output_used = 0;
+
+void bsp_tx_char(char ch) { (void)ch; }
+
+void bsp_tx_block(const char* data, uint32_t len)
+{ memcpy(output_buffer + output_used, data, len);
+  output_used += len; }
+
+uint32_t bsp_tx_available() { return UINT32_MAX; }
+
+void bsp_tx_flush() {}
+
+class test_module : public i_kernel_module
+{ public:
+    explicit test_module(const char* module)
+    { name = module;
+      version = "0.1";
+      type = "test";
+      period = 0;
+      polled = 0;
+      ready = true; }
+
+    void init() {}
+    void poll() {} };
+
+test_module adc("adc");
+test_module uart("uart");
+uint32_t evaluated = 0;
+
+/** \brief argument that counts its evaluations */
+static uint32_t value()
+{ evaluated++;
+  return evaluated; }
+
+TEST_GROUP(log_tests)
+{ void setup()
+  { memset(output_buffer, 0, sizeof(output_buffer));
+    output_used = 0;
+    evaluated = 0;
+    logger::level = LOG_LEVEL;
+    logger::count = 0; }
+
+  void teardown() {} };
+
+TEST(log_tests, line_has_level_and_module)
+{ LOG_WARN(adc, PRINT_FMT("channel %u is %s"), 3u, "lost");
+  LOG_INFO(uart, PRINT_FMT("ready"));
+  STRCMP_EQUAL("W adc: channel 3 is lost\nI uart: ready\n", output_buffer); }
+
+TEST(log_tests, below_compile_threshold_is_removed)
+{ static_assert(LOG_LEVEL == LOG_LEVEL_INFO, "default threshold");
+  logger::level = LOG_LEVEL_TRACE;
+  LOG_DEBUG(adc, PRINT_FMT("%u"), value());
+  LOG_TRACE(adc, PRINT_FMT("%u"), value());
+  CHECK(evaluated == 0);
+  CHECK(output_used == 0); }
+
+TEST(log_tests, module_level_short_circuits)
+{ CHECK(logger::set("adc", LOG_LEVEL_ERROR) == ERR_OK);
+  LOG_WARN(adc, PRINT_FMT("%u"), value());
+  LOG_WARN(uart, PRINT_FMT("%u"), value());
+  CHECK(evaluated == 1);
+  STRCMP_EQUAL("W uart: 1\n", output_buffer);
+  LOG_ERROR(adc, PRINT_FMT("%u"), value());
+  STRCMP_EQUAL("W uart: 1\nE adc: 2\n", output_buffer); }
+
+TEST(log_tests, module_is_found_by_name)
+{ static char name[] = "uart";
+  CHECK(logger::set(name, LOG_LEVEL_NONE) == ERR_OK);
+  CHECK(logger::get("uart") == LOG_LEVEL_NONE);
+  CHECK(logger::get("adc") == LOG_LEVEL);
+  LOG_ERROR(uart, PRINT_FMT("muted"));
+  CHECK(output_used == 0);
+  CHECK(logger::set("uart", LOG_LEVEL_INFO) == ERR_OK);
+  CHECK(logger::count == 1);
+  LOG_INFO(uart, PRINT_FMT("back"));
+  STRCMP_EQUAL("I uart: back\n", output_buffer); }
+
+TEST(log_tests, table_overflow)
+{ static const char* names[] = { "a", "b", "c", "d", "e", "f", "g", "h",
+                                 "i" };
+  static_assert(sizeof(names) / sizeof(names[0]) == LOG_MODULES + 1,
+                "one more than the table");
+
+  for (uint32_t i = 0; i < LOG_MODULES; i++)
+  { CHECK(logger::set(names[i], LOG_LEVEL_WARN) == ERR_OK); }
+
+  CHECK(logger::set(names[LOG_MODULES], LOG_LEVEL_WARN) ==
+        ERR_BUFFER_OVERFLOW);
+  CHECK(logger::get(names[LOG_MODULES]) == LOG_LEVEL); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
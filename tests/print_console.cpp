@@ -0,0 +1,84 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstring>
+#include "bsp/bsp.h"
+#include "io/print.hpp"
+#include "core/errcode.hpp"
+
+char output_buffer[256] = { 0 };
+uint32_t output_used = 0;
+uint32_t blocks = 0;
+uint32_t flushes = 0;
+uint32_t space = UINT32_MAX;
+
+void bsp_tx_char(char ch) { (void)ch; }
+
+void bsp_tx_block(const char* data, uint32_t len)
+{ memcpy(output_buffer + output_used, data, len);
+  output_used += len;
+  blocks++; }
+
+uint32_t bsp_tx_available() { return space; }
+
+void bsp_tx_flush() { flushes++; }
+
+TEST_GROUP(print_console_tests)
+{ void setup()
+  { memset(output_buffer, 0, sizeof(output_buffer));
+    output_used = 0;
+    blocks = 0;
+    flushes = 0;
+    space = UINT32_MAX;
+    print::blocking = true;
+    print::dropped = 0; }
+
+  void teardown() {} };
+
+TEST(print_console_tests, statement_is_one_block)
+{ print()("value: ").u(12345)(" units");
+  STRCMP_EQUAL("value: 12345 units", output_buffer);
+  CHECK(blocks == 1); }
+
+TEST(print_console_tests, new_line_flushes)
+{ print out;
+  out("first\n")("second");
+  STRCMP_EQUAL("first\n", output_buffer);
+  CHECK(blocks == 1);
+  out.flush();
+  STRCMP_EQUAL("first\nsecond", output_buffer);
+  CHECK(blocks == 2);
+  CHECK(flushes == 1); }
+
+TEST(print_console_tests, full_line_flushes)
+{ print out;
+  char text[PRINT_LINE_SIZE + 11];
+  memset(text, 'a', sizeof(text) - 1);
+  text[sizeof(text) - 1] = '\0';
+  out(text);
+  CHECK(blocks == 1);
+  CHECK(output_used == PRINT_LINE_SIZE);
+  out.flush();
+  CHECK(output_used == PRINT_LINE_SIZE + 10); }
+
+TEST(print_console_tests, non_blocking_drops)
+{ print::blocking = false;
+  space = 4;
+  print()("abc");
+  print()("too long");
+  STRCMP_EQUAL("abc", output_buffer);
+  CHECK(print::dropped == 8);
+  space = 100;
+  print()("ok\n");
+  STRCMP_EQUAL("abcok\n", output_buffer);
+  CHECK(print::dropped == 8); }
+
+TEST(print_console_tests, buffer_mode_untouched)
+{ char buf[8] = { 0 };
+  print(buf, sizeof(buf))("ab\ncd");
+  STRCMP_EQUAL("ab\ncd", buf);
+  CHECK(blocks == 0); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
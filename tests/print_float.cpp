@@ -0,0 +1,77 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "io/print.hpp"
+#include "core/errcode.hpp"
+#include "bsp/bsp.h"
+
+void bsp_tx_char(char ch) { (void)ch; }
+
+char buffer[400];
+
+TEST_GROUP(print_float_tests)
+{ void setup() { memset(buffer, 0, sizeof(buffer)); }
+  void teardown() {} };
+
+TEST(print_float_tests, fixed)
+{ print p(buffer, sizeof(buffer));
+  p.f(3.14159).s(" ").f(-0.5f, 3).s(" ").f(42.0, 0).s(" ").f(0.1, 20)
+  .s(" ").f(1.0f, 1, PRINT_NO_LIMITS, 0, true);
+  STRCMP_EQUAL("3.14 -0.500 42 0.10000000000000000555 +1.0", buffer);
+  CHECK(p.errcode == ERR_OK); }
+
+TEST(print_float_tests, half_to_even)
+{ print p(buffer, sizeof(buffer));
+  p.f(0.125, 2).s(" ").f(0.375, 2).s(" ").f(2.5, 0).s(" ").f(3.5, 0)
+  .s(" ").f(9.995, 2).s(" ").f(99.5, 0);
+  STRCMP_EQUAL("0.12 0.38 2 4 9.99 100", buffer); }
+
+TEST(print_float_tests, special_values)
+{ print p(buffer, sizeof(buffer));
+  p.f(NAN).s(" ").f(INFINITY).s(" ").f(-INFINITY).s(" ")
+  .f(INFINITY, 2, PRINT_NO_LIMITS, 0, true).s(" ").f(-0.0, 1);
+  STRCMP_EQUAL("nan inf -inf +inf -0.0", buffer); }
+
+TEST(print_float_tests, extremes)
+{ print p(buffer, sizeof(buffer));
+  p.f(5e-324, PRINT_SHORTEST).s(" ").f(1e-45f, PRINT_SHORTEST).s(" ")
+  .f(5e-324, 40);
+  STRCMP_EQUAL("5e-324 1e-45 0.0000000000000000000000000000000000000000",
+               buffer);
+
+  memset(buffer, 0, sizeof(buffer));
+  print q(buffer, sizeof(buffer));
+  q.f(DBL_MAX, 0);
+  CHECK(strlen(buffer) == 309);
+  CHECK(!strncmp(buffer, "179769313486231570814527423731704356798", 39));
+  CHECK(!strcmp(buffer + 289, "50404026184124858368")); }
+
+TEST(print_float_tests, shortest)
+{ print p(buffer, sizeof(buffer));
+  p.f(0.1, PRINT_SHORTEST).s(" ").f(0.1f, PRINT_SHORTEST).s(" ")
+  .f(123.456, PRINT_SHORTEST).s(" ").f(100.0, PRINT_SHORTEST).s(" ")
+  .f(0.000001, PRINT_SHORTEST).s(" ").f(1e-7, PRINT_SHORTEST).s(" ")
+  .f(1e21, PRINT_SHORTEST).s(" ").f(DBL_MAX, PRINT_SHORTEST).s(" ")
+  .f(FLT_MAX, PRINT_SHORTEST).s(" ").f(0.0, PRINT_SHORTEST);
+  STRCMP_EQUAL("0.1 0.1 123.456 100 0.000001 1e-7 1e+21 "
+               "1.7976931348623157e+308 3.4028235e+38 0", buffer); }
+
+TEST(print_float_tests, layout)
+{ print p(buffer, sizeof(buffer));
+  p.f(1234567.891, 2, 16, 3, false, ALIGN_RIGHT).s("|")
+  .f(-2.5, 1, 8, 0, false, ALIGN_CENTER, '_').s("|").f(123.456, 2, 5);
+  STRCMP_EQUAL("    1 234 567.89|__-2.5__|[123]", buffer); }
+
+TEST(print_float_tests, wrong_precision)
+{ print p(buffer, sizeof(buffer));
+  p.f(1.0, PRINT_FLOAT_PRECISION + 1);
+  CHECK(p.errcode == ERR_INVALID_ARGUMENT);
+  STRCMP_EQUAL("", buffer); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
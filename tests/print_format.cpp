@@ -0,0 +1,79 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstring>
+#include "io/print.hpp"
+#include "core/errcode.hpp"
+#include "bsp/bsp.h"
+
+void bsp_tx_char(char ch) { (void)ch; }
+
+char buffer[160];
+
+TEST_GROUP(print_format_tests)
+{ void setup() { memset(buffer, 0, sizeof(buffer)); }
+  void teardown() {} };
+
+TEST(print_format_tests, parsed_at_compile_time)
+{ constexpr print_spec spec = print_format_parse("a=%-+'12.3f;", 0);
+  static_assert(spec.type == 'f', "type");
+  static_assert(spec.from == 0 && spec.to == 2, "literal");
+  static_assert(spec.left && spec.plus && spec.group, "flags");
+  static_assert(spec.width == 12 && spec.prec == 3, "width");
+  static_assert(print_format_count("%u%% %s") == 3, "count");
+  static_assert(print_format_args("%u%% %s", 3) == 2, "arguments");
+  CHECK(print_format_parse("a=%-+'12.3f;", 1).type == 0); }
+
+TEST(print_format_tests, integers)
+{ print p(buffer, sizeof(buffer));
+  p.fmt(PRINT_FMT("%u %d %+i %x %X %o %b"), 42u, -7, 5, 0xBEEFu, 0xCAFEu,
+        8u, (uint8_t)5).t();
+  STRCMP_EQUAL("42 -7 +5 beef CAFE 10 101", buffer);
+  CHECK(p.errcode == ERR_OK); }
+
+TEST(print_format_tests, width_and_flags)
+{ print p(buffer, sizeof(buffer));
+  p.fmt(PRINT_FMT("[%5u][%-5u][%05u][%08x][%'u][%'x]"), 42u, 42u, 42u,
+        0xBEEFu, 1234567u, 0x12345678u).t();
+  STRCMP_EQUAL("[   42][42   ][00042][0000beef][1 234 567][1234 5678]",
+               buffer); }
+
+TEST(print_format_tests, floats_strings_and_chars)
+{ print p(buffer, sizeof(buffer));
+  p.fmt(PRINT_FMT("%f %.3f %+g %8.1f|%s|%-6s|%3c|%%"), 3.14159, 2.5f, 0.1,
+        -1.25, "ok", "left", 'z').t();
+  STRCMP_EQUAL("3.14 2.500 +0.1     -1.2|ok|left  |  z|%", buffer); }
+
+TEST(print_format_tests, narrow_width_is_not_cut)
+{ print p(buffer, sizeof(buffer));
+  p.fmt(PRINT_FMT("[%3u][%8.3f][%2d][%1u][%1d][%2s][%-2x]"), 12345u,
+        123456.789, -100, 10u, -5, "long", 0xABCu).t();
+  STRCMP_EQUAL("[12345][123456.789][-100][10][-5][long][abc]", buffer);
+  CHECK(p.errcode == ERR_OK);
+  p.s("x", 2).t();
+  STRCMP_EQUAL("[12345][123456.789][-100][10][-5][long][abc]x ", buffer);
+  print(buffer, sizeof(buffer)).s("long", 2).t();
+  STRCMP_EQUAL("[]", buffer); }
+
+TEST(print_format_tests, left_cancels_zero)
+{ print p(buffer, sizeof(buffer));
+  p.fmt(PRINT_FMT("[%-05u][%-04x][%-06o][%-0'6b][%0-4u]"), 42u, 0xABu, 8u,
+        5u, 7u).t();
+  STRCMP_EQUAL("[42   ][ab  ][10    ][101   ][7   ]", buffer); }
+
+TEST(print_format_tests, literal_only)
+{ print p(buffer, sizeof(buffer));
+  p.fmt(PRINT_FMT("100%% done")).t();
+  STRCMP_EQUAL("100% done", buffer); }
+
+TEST(print_format_tests, overflow)
+{ char small[8] = { 0 };
+  print p(small, sizeof(small));
+  p.fmt(PRINT_FMT("value %u and more"), 12345u);
+  CHECK(p.errcode == ERR_BUFFER_OVERFLOW);
+  CHECK(!memcmp(small, "value 12", 8)); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
@@ -0,0 +1,58 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstring>
+#include "io/print.hpp"
+#include "core/errcode.hpp"
+#include "bsp/bsp.h"
+
+void bsp_tx_char(char ch) { (void)ch; }
+
+char buffer[160];
+
+TEST_GROUP(print_int_tests)
+{ void setup() { memset(buffer, 0, sizeof(buffer)); }
+  void teardown() {} };
+
+TEST(print_int_tests, signed_values)
+{ print p(buffer, sizeof(buffer));
+  p.i(-5).s(" ").i(0).s(" ").i(7, PRINT_NO_LIMITS, 0, true).s(" ")
+  .i(-1234567, PRINT_NO_LIMITS, 3).s(" ").i(INT64_MIN);
+  STRCMP_EQUAL("-5 0 +7 -1 234 567 -9223372036854775808", buffer);
+  CHECK(p.errcode == ERR_OK); }
+
+TEST(print_int_tests, hex)
+{ print p(buffer, sizeof(buffer));
+  p.x(0).s(" ").x(0xBEEF).s(" ").x(0x1F, 4).s(" ").X(0xDEADBEEFCAFEULL)
+  .s(" ").x(0x12345678, 0, PRINT_NO_LIMITS, 4);
+  STRCMP_EQUAL("0 beef 001f DEADBEEFCAFE 1234 5678", buffer);
+  CHECK(p.errcode == ERR_OK); }
+
+TEST(print_int_tests, hex_too_many_digits)
+{ print p(buffer, sizeof(buffer));
+  p.x(1, 17);
+  CHECK(p.errcode == ERR_INVALID_ARGUMENT); }
+
+TEST(print_int_tests, octal_and_binary)
+{ print p(buffer, sizeof(buffer));
+  p.o(8).s(" ").o(0xFFFFFFFFFFFFFFFFULL).s(" ").b(5).s(" ")
+  .b(0xA5, PRINT_NO_LIMITS, 4);
+  STRCMP_EQUAL("10 1777777777777777777777 101 1010 0101", buffer); }
+
+TEST(print_int_tests, binary_64_bit_separated)
+{ print p(buffer, sizeof(buffer));
+  p.b(0x8000000000000001ULL, PRINT_NO_LIMITS, 8);
+  STRCMP_EQUAL("10000000 00000000 00000000 00000000 "
+               "00000000 00000000 00000000 00000001", buffer); }
+
+TEST(print_int_tests, buffer_overflow)
+{ char small[4] = { 0 };
+  print p(small, sizeof(small));
+  p.u(123456);
+  CHECK(p.errcode == ERR_BUFFER_OVERFLOW);
+  MEMCMP_EQUAL("1234", small, 4); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
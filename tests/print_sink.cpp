@@ -0,0 +1,89 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstring>
+#include "bsp/bsp.h"
+#include "core/errcode.hpp"
+#include "io/print_sink.hpp"
+
+uint32_t blocks = 0;
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+void bsp_tx_char(char ch) { (void)ch; }
+void bsp_tx_block(const char* data, uint32_t len)
+{ (void)data; (void)len; blocks++; }
+uint32_t bsp_tx_available() { return UINT32_MAX; }
+void bsp_tx_flush() {}
+
+/** \brief read all of the text from the pipe */
+static void drain(i_pipe& p, char* text)
+{ text += strlen(text);
+  text[p.read(text, p.fullness())] = '\0'; }
+
+TEST_GROUP(print_sink_tests)
+{ void setup() { blocks = 0; }
+
+  void teardown() {} };
+
+TEST(print_sink_tests, pipe_gets_text)
+{ pipe<64> p;
+  print_pipe_sink sink(p);
+  print out(sink);
+  out.fmt(PRINT_FMT("adc %u: %.3f V\n"), 3u, 1.25f).flush().t();
+  CHECK(out.errcode == ERR_OK);
+  CHECK(out.printed() == 15);
+  char text[64] = { 0 };
+  drain(p, text);
+  STRCMP_EQUAL("adc 3: 1.250 V\n", text);
+  CHECK(blocks == 0); }
+
+TEST(print_sink_tests, full_pipe_is_busy)
+{ pipe<8> p;
+  print_pipe_sink sink(p);
+  print out(sink);
+  out("hello ").u(12345)(" world");
+  CHECK(out.errcode == ERR_BUSY);
+  CHECK(out.printed() == 8);
+  CHECK(p.fullness() == 8); }
+
+TEST(print_sink_tests, statement_is_resumed)
+{ pipe<8> p;
+  print_pipe_sink sink(p);
+  char text[64] = { 0 };
+  uint32_t done = 0;
+  uint32_t rounds = 0;
+
+  while (true)
+  { print out(sink, done);
+    out("hello ").u(12345, 7)(" world\n");
+    done = out.printed();
+    drain(p, text);
+    rounds++;
+
+    if (out.errcode == ERR_OK) { break; }
+
+    CHECK(out.errcode == ERR_BUSY); }
+
+  STRCMP_EQUAL("hello 12345   world\n", text);
+  CHECK(rounds == 3); }
+
+TEST(print_sink_tests, circular_buffer_gets_text)
+{ circular_buffer_static<char, 8> buf;
+  print_circular_sink<8> sink(buf);
+  print out(sink);
+  out.x(0xBEEFu, 4)(" ").i(-12).x(0xABCDEFu);
+  CHECK(out.errcode == ERR_BUSY);
+  CHECK(buf.memory_used() == 8);
+  char text[9] = { 0 };
+
+  for (uint32_t i = 0; i < 8; i++)
+  { text[i] = *buf.fetch_tail();
+    buf.pop_tail(); }
+
+  STRCMP_EQUAL("beef -12", text); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
@@ -45,6 +45,11 @@ TEST(print_string_tests, print_limited)
 { print().print_string((char*)"123456", 4, STD_ALIGN, STD_SPACER);
   MEMCMP_EQUAL("[12]", output_buffer, sizeof("[12]")); }
 
+TEST(print_string_tests, print_limited_to_brackets)
+{ print().print_string((char*)"123456", 2, STD_ALIGN, STD_SPACER);
+  print().print_string((char*)"123456", 1, STD_ALIGN, STD_SPACER);
+  MEMCMP_EQUAL("[][]", output_buffer, sizeof("[][]")); }
+
 TEST(print_string_tests, print_with_left_alignment_spacer)
 { print().print_string((char*)"123", 6, ALIGN_LEFT, '_');
   MEMCMP_EQUAL("123___", output_buffer, sizeof("123___")); }
@@ -101,5 +106,14 @@ TEST(print_string_tests, print_no_limits_in_buffer_wrapped_explicit_non_const)
   char expected[10] = { '1', '2', '3', 0, 0, 0, 0, 0, 0, 0 };
   MEMCMP_EQUAL(expected, buffer, sizeof(buffer)); }
 
+TEST(print_string_tests, huge_block_in_buffer_overflow)
+{ char buffer[8] = { 0 };
+  print p(buffer, 4);
+  p("1").tx("23456789", UINT32_MAX);
+  char expected[8] = { '1', '2', '3', '4', 0, 0, 0, 0 };
+  MEMCMP_EQUAL(expected, buffer, sizeof(buffer));
+  CHECK(p.counter == 4);
+  CHECK(p.errcode == ERR_BUFFER_OVERFLOW); }
+
 int main(int argc, char** argv)
 { return CommandLineTestRunner::RunAllTests(argc, argv); }
@@ -21,6 +21,15 @@ TEST(print_uint_tests, simple_print)
   CHECK(p.counter == 3);
   CHECK(p.errcode == ERR_OK); }
 
+TEST(print_uint_tests, zero)
+{ char buffer[4] = { 0 };
+  print p(buffer, sizeof(buffer));
+  p.u(0);
+  char expected[4] = { '0', 0, 0, 0 };
+  MEMCMP_EQUAL(expected, buffer, sizeof(buffer));
+  CHECK(p.counter == 1);
+  CHECK(p.errcode == ERR_OK); }
+
 TEST(print_uint_tests, maximum_value)
 { char buffer[11] = { 0 };
   print p(buffer, sizeof(buffer));
@@ -40,5 +49,28 @@ TEST(print_uint_tests, maximum_value_separated)
   CHECK(p.counter == 13);
   CHECK(p.errcode == ERR_OK); }
 
+TEST(print_uint_tests, digit_count_boundaries)
+{ uint64_t value = 1;
+
+  for (uint32_t digits = 1; digits <= 20; digits++)
+  { char buffer[48] = { 0 };
+    print p(buffer, sizeof(buffer));
+    p.u(value - 1).u(value);
+    CHECK(p.counter == ((digits > 1) ? digits - 1 : 1) + digits);
+
+    if (digits < 20) { value *= 10; } } }
+
+TEST(print_uint_tests, maximum_64_bit_value)
+{ char buffer[32] = { 0 };
+  print p(buffer, sizeof(buffer));
+  p.u(0xFFFFFFFFFFFFFFFFULL, PRINT_NO_LIMITS, 3);
+  STRCMP_EQUAL("18 446 744 073 709 551 615", buffer); }
+
+TEST(print_uint_tests, aligned)
+{ char buffer[16] = { 0 };
+  print p(buffer, sizeof(buffer));
+  p.u(42, 6, 0, ALIGN_RIGHT, '.');
+  STRCMP_EQUAL("....42", buffer); }
+
 int main(int argc, char** argv)
 { return CommandLineTestRunner::RunAllTests(argc, argv); }
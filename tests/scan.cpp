@@ -0,0 +1,216 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "core/errcode.hpp"
+#include "io/print.hpp"
+#include "io/scan.hpp"
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+void bsp_tx_char(char ch) { (void)ch; }
+
+/** \brief scan of the string */
+#define SCAN(str) scan(str, sizeof(str) - 1)
+
+TEST_GROUP(scan_tests)
+{ void setup() {}
+
+  void teardown() {} };
+
+TEST(scan_tests, unsigned_values)
+{ uint64_t a = 1, b = 0, c = 0, d = 7;
+  scan in = SCAN("0 42\t18446744073709551615 18446744073709551616");
+  in.u(a).u(b).u(c).u(d);
+  CHECK(a == 0);
+  CHECK(b == 42);
+  CHECK(c == UINT64_MAX);
+  CHECK(d == 7);
+  CHECK(in.errcode == ERR_OUT_OF_RANGE);
+  CHECK(in.position() == 26); }
+
+TEST(scan_tests, range_of_type)
+{ uint8_t a = 0, b = 0;
+  scan in = SCAN("255,256");
+  in.u(a)(',').u(b);
+  CHECK(a == 255);
+  CHECK(b == 0);
+  CHECK(in.errcode == ERR_OUT_OF_RANGE);
+  CHECK(in.position() == 4); }
+
+TEST(scan_tests, long_digits)
+{ uint64_t a = 0, b = 0;
+  uint32_t c = 0;
+  scan in = SCAN("000000000000123456789012 12345678901234567890 "
+                 "00000000000000000000000004294967295");
+  in.u(a).u(b).u(c);
+  CHECK(in.errcode == ERR_OK);
+  CHECK(a == 123456789012ULL);
+  CHECK(b == 12345678901234567890ULL);
+  CHECK(c == UINT32_MAX);
+  CHECK(in.end()); }
+
+TEST(scan_tests, signed_values)
+{ int8_t a = 0, b = 0, e = 0;
+  int64_t c = 0;
+  int32_t d = 0;
+  scan in = SCAN("-128 127 -9223372036854775808 +5 -129");
+  in.i(a).i(b).i(c).i(d).i(e);
+  CHECK(a == -128);
+  CHECK(b == 127);
+  CHECK(c == INT64_MIN);
+  CHECK(d == 5);
+  CHECK(e == 0);
+  CHECK(in.errcode == ERR_OUT_OF_RANGE);
+  CHECK(in.position() == 33); }
+
+TEST(scan_tests, hex_values)
+{ uint32_t a = 0;
+  uint16_t b = 0;
+  uint64_t c = 0;
+  scan in = SCAN("DEADbeef 00ff 0123456789abcdef0 123456789abcdef01");
+  in.x(a).x(b).x(c).x(c);
+  CHECK(a == 0xDEADBEEF);
+  CHECK(b == 0xFF);
+  CHECK(c == 0x123456789ABCDEF0ULL);
+  CHECK(in.errcode == ERR_OUT_OF_RANGE);
+  CHECK(in.position() == 32); }
+
+TEST(scan_tests, doubles_match_strtod)
+{ static const char* texts[] =
+  { "3.14159", "-0.001", "1e10", "2.5e-3", "0.1", "123456789.123456789",
+    "1.7976931348623157e308", "4.9e-324", "2.2250738585072014e-308",
+    "9007199254740993", "0.000000000000000000000000000001234", "5.",
+    "7E+2", "100000000000000000000000", "-0", "1.5e" };
+
+  for (const char* text : texts)
+  { double val = 0;
+    scan in(text, (uint32_t)strlen(text));
+    in.f(val);
+    CHECK(in.errcode == ERR_OK);
+    char* end;
+    CHECK(val == strtod(text, &end));
+    CHECK(in.position() == (uint32_t)(end - text)); } }
+
+TEST(scan_tests, floats_match_strtof)
+{ static const char* texts[] =
+  { "3.14159", "-0.001", "1e10", "2.5e-3", "0.1", "16777217",
+    "1.17549435e-38", "3.4028235e38", "4807.038", "1e-45",
+    "0.333333333333333333333" };
+
+  for (const char* text : texts)
+  { float val = 0;
+    scan in(text, (uint32_t)strlen(text));
+    in.f(val);
+    CHECK(in.errcode == ERR_OK);
+    CHECK(val == strtof(text, nullptr)); } }
+
+TEST(scan_tests, special_values)
+{ double a = 0, b = 0, c = 0;
+  float d = 0;
+  scan in = SCAN("inf -inf nan 1e39");
+  in.f(a).f(b).f(c);
+  CHECK(a > 1e308);
+  CHECK(b < -1e308);
+  CHECK(c != c);
+  in.f(d);
+  CHECK(in.errcode == ERR_OUT_OF_RANGE);
+  CHECK(in.position() == 13); }
+
+TEST(scan_tests, printed_values_are_read_back)
+{ char text[64];
+  double val = 0;
+
+  for (double v : { 0.1, 1.0 / 3, 6.02214076e23, -2.5e-300, 1e21 })
+  { print(text, sizeof(text)).f(v, PRINT_SHORTEST).t();
+    scan(text, (uint32_t)strlen(text)).f(val);
+    CHECK(val == v); } }
+
+TEST(scan_tests, errors_point_to_value)
+{ uint32_t a = 0;
+  scan in = SCAN("1,x");
+  in.u(a)(',').u(a);
+  CHECK(in.errcode == ERR_INVALID_DATA);
+  CHECK(in.position() == 2);
+  CHECK(a == 1);
+  scan text = SCAN("$GPRMC,");
+  text("$GPGGA,");
+  CHECK(text.errcode == ERR_INVALID_DATA);
+  CHECK(text.position() == 0);
+  scan dot = SCAN(" .e5");
+  double d = 0;
+  dot.f(d);
+  CHECK(dot.errcode == ERR_INVALID_DATA);
+  CHECK(dot.position() == 1);
+  scan over = SCAN("12");
+  over.u(a).u(a);
+  CHECK(over.errcode == ERR_BUFFER_OVERRUN);
+  CHECK(a == 12); }
+
+TEST(scan_tests, nmea_sentence)
+{ char time[16], ns[2], ew[2], age[8];
+  double lat = 0, lon = 0;
+  float hdop = 0, alt = 0, geoid = 0;
+  uint8_t fix = 0, sats = 0, sum = 0;
+  scan in = SCAN("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,"
+                 "46.9,M,,*47\r\n");
+  in("$GPGGA,").field(time, sizeof(time), ',').f(lat)(',')
+  .field(ns, sizeof(ns), ',').f(lon)(',').field(ew, sizeof(ew), ',')
+  .u(fix)(',').u(sats)(',').f(hdop)(',').f(alt)(",M,").f(geoid)(",M,")
+  .field(age, sizeof(age), ',')('*').x(sum).skip('\n');
+  CHECK(in.errcode == ERR_OK);
+  STRCMP_EQUAL("123519", time);
+  CHECK(lat == 4807.038);
+  STRCMP_EQUAL("N", ns);
+  CHECK(lon == 1131.0);
+  STRCMP_EQUAL("E", ew);
+  CHECK(fix == 1);
+  CHECK(sats == 8);
+  CHECK(hdop == 0.9f);
+  CHECK(alt == 545.4f);
+  CHECK(geoid == 46.9f);
+  STRCMP_EQUAL("", age);
+  CHECK(sum == 0x47);
+  CHECK(in.end()); }
+
+TEST(scan_tests, field_overflow)
+{ char out[4];
+  scan in = SCAN("abcd,ef");
+  in.field(out, sizeof(out), ',');
+  CHECK(in.errcode == ERR_BUFFER_OVERFLOW);
+  CHECK(in.position() == 0); }
+
+TEST(scan_tests, pipe_source)
+{ pipe<1024> p;
+  char line[16];
+  uint32_t expected = 0;
+
+  for (uint32_t i = 0; i < 100; i++)
+  { print out(line, sizeof(line));
+    out.u(i * 1000)(",").t();
+    p.write(line, (uint32_t)strlen(line));
+    expected += i * 1000; }
+
+  p.write((void*)"end\n", 4);
+  uint32_t total = 0;
+  scan in(p);
+
+  for (uint32_t i = 0; i < 100; i++)
+  { uint32_t value = 0;
+    in.u(value)(',');
+    total += value; }
+
+  in("end").skip('\n');
+  CHECK(in.errcode == ERR_OK);
+  CHECK(total == expected);
+  CHECK(in.end());
+  uint32_t value;
+  in.u(value);
+  CHECK(in.errcode == ERR_NOT_READY);
+  CHECK(in.position() == 1 + 9 * 4 + 90 * 5 + 100 + 4); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
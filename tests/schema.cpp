@@ -0,0 +1,112 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include "tools/schema.hpp"
+#include "core/errcode.hpp"
+#include <cstdint>
+#include <cstring>
+
+class test_message
+{ public:
+    uint8_t kind;
+    uint16_t addr;
+    uint32_t count;
+    char name[6];
+    uint16_t samples[3]; };
+
+typedef schema<raw_field<&test_message::kind>,
+               be_field<&test_message::addr>,
+               le_field<&test_message::count>,
+               string_field<&test_message::name>,
+               be_array<&test_message::samples>> test_schema;
+
+static_assert(test_schema::size == 1 + 2 + 4 + 6 + 6, "wrong size");
+static_assert(test_schema::offset(3) == 7, "wrong offset");
+
+static const uint8_t encoded[test_schema::size] =
+{ 0x05,
+  0x12, 0x34,
+  0x78, 0x56, 0x34, 0x12,
+  'a', 'b', 'c', 0, 0, 0,
+  0x00, 0x01, 0x02, 0x03, 0xAB, 0xCD };
+
+static test_message sample()
+{ test_message msg;
+  memset(&msg, 0x77, sizeof(msg));
+  msg.kind = 0x05;
+  msg.addr = 0x1234;
+  msg.count = 0x12345678;
+  strcpy(msg.name, "abc");
+  msg.samples[0] = 0x0001;
+  msg.samples[1] = 0x0203;
+  msg.samples[2] = 0xABCD;
+  return msg; }
+
+TEST_GROUP(schema_unit_tests)
+{ void setup() {}
+  void teardown() {} };
+
+TEST(schema_unit_tests, offsets)
+{ CHECK(test_schema::fields == 5);
+  CHECK(test_schema::offset(0) == 0);
+  CHECK(test_schema::offset(1) == 1);
+  CHECK(test_schema::offset(2) == 3);
+  CHECK(test_schema::offset(4) == 13);
+  CHECK(test_schema::offset(5) == test_schema::size); }
+
+TEST(schema_unit_tests, pack)
+{ uint8_t buffer[32] = { 0 };
+  serializer out(buffer, sizeof(buffer));
+  out.v<uint8_t>(0xEE);
+  test_schema::pack(sample(), out).v<uint8_t>(0xEF);
+  CHECK(out.errcode == ERR_OK);
+  CHECK(out.pos == test_schema::size + 2);
+  CHECK(buffer[0] == 0xEE);
+  MEMCMP_EQUAL(encoded, buffer + 1, test_schema::size);
+  CHECK(buffer[test_schema::size + 1] == 0xEF); }
+
+TEST(schema_unit_tests, unpack)
+{ test_message msg;
+  memset(&msg, 0, sizeof(msg));
+  deserializer in((void*)encoded, sizeof(encoded));
+  test_schema::unpack(msg, in);
+  CHECK(in.errcode == ERR_OK);
+  CHECK(in.pos == test_schema::size);
+  CHECK(msg.kind == 0x05);
+  CHECK(msg.addr == 0x1234);
+  CHECK(msg.count == 0x12345678);
+  STRCMP_EQUAL("abc", msg.name);
+  CHECK(msg.samples[0] == 0x0001);
+  CHECK(msg.samples[1] == 0x0203);
+  CHECK(msg.samples[2] == 0xABCD); }
+
+TEST(schema_unit_tests, long_string_is_cut)
+{ test_message msg = sample();
+  memcpy(msg.name, "abcdefgh", sizeof(msg.name));
+  uint8_t buffer[test_schema::size];
+  test_schema::write(msg, buffer);
+  MEMCMP_EQUAL("abcde", buffer + test_schema::offset(3), 6);
+  test_message back;
+  test_schema::read(back, buffer);
+  STRCMP_EQUAL("abcde", back.name); }
+
+TEST(schema_unit_tests, overflow)
+{ uint8_t buffer[test_schema::size - 1];
+  memset(buffer, 0x55, sizeof(buffer));
+  serializer out(buffer, sizeof(buffer));
+  test_schema::pack(sample(), out);
+  CHECK(out.errcode == ERR_BUFFER_OVERFLOW);
+  CHECK(out.pos == 0);
+  CHECK(buffer[0] == 0x55); }
+
+TEST(schema_unit_tests, overrun)
+{ test_message msg = sample();
+  deserializer in((void*)encoded, sizeof(encoded) - 1);
+  test_schema::unpack(msg, in);
+  CHECK(in.errcode == ERR_BUFFER_OVERRUN);
+  CHECK(in.pos == 0);
+  CHECK(msg.addr == 0x1234); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
@@ -125,5 +125,289 @@ TEST(serializer_unit_tests, deserializer_string_overrun)
   char expected[3] = { 'a', 'b', 0 };
   MEMCMP_EQUAL(expected, str, sizeof(str)); }
 
+TEST(serializer_unit_tests, deserializer_string_unterminated)
+{ char buffer[4] = { 'a', 'b', 'c', 'd' };
+  deserializer ds(buffer, sizeof(buffer));
+  char str[8] = { 'x', 'x', 'x', 'x', 'x', 'x', 'x', 'x' };
+  ds.s(str, sizeof(str));
+  CHECK(ds.pos == 4);
+  CHECK(ds.errcode == ERR_BUFFER_OVERRUN);
+  STRCMP_EQUAL("abcd", str);
+  // nothing is left in the sequence
+  ds.s(str, sizeof(str));
+  CHECK(ds.pos == 4);
+  STRCMP_EQUAL("", str); }
+
+TEST(serializer_unit_tests, deserializer_string_at_end)
+{ char buffer[2] = { 'a', 0 };
+  deserializer ds(buffer, sizeof(buffer));
+  char str[4] = { 'x', 'x', 'x', 'x' };
+  ds.s(str, sizeof(str)).s(str, sizeof(str));
+  CHECK(ds.pos == 2);
+  CHECK(ds.errcode == ERR_BUFFER_OVERRUN);
+  STRCMP_EQUAL("", str); }
+
+TEST(serializer_unit_tests, fixed_byte_order)
+{ uint8_t buffer[14] = { 0 };
+  serializer s(buffer, sizeof(buffer));
+  s.be<uint16_t>(0x1234).le<uint32_t>(0x12345678)
+  .hn().be<uint64_t>(0x0102030405060708);
+  uint8_t expected[14] = { 0x12, 0x34, 0x78, 0x56, 0x34, 0x12,
+                           0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+  MEMCMP_EQUAL(expected, buffer, sizeof(buffer));
+  CHECK(s.pos == 14);
+  CHECK(s.errcode == ERR_OK);
+  deserializer ds(buffer, sizeof(buffer));
+  uint16_t a = 0;
+  uint32_t b = 0;
+  uint64_t c = 0;
+  ds.be<uint16_t>(a).le<uint32_t>(b).be<uint64_t>(c);
+  CHECK(a == 0x1234);
+  CHECK(b == 0x12345678);
+  CHECK(c == 0x0102030405060708);
+  CHECK(ds.errcode == ERR_OK); }
+
+TEST(serializer_unit_tests, odd_size_swapped)
+{ uint8_t buffer[3] = { 0 };
+  uint8_t value[3] = { 1, 2, 3 };
+  serializer s(buffer, sizeof(buffer));
+  s.hn().v<uint8_t[3]>(&value);
+  uint8_t expected[3] = { 3, 2, 1 };
+  MEMCMP_EQUAL(expected, buffer, sizeof(buffer)); }
+
+TEST(serializer_unit_tests, value_overflow)
+{ uint8_t buffer[3] = { 0 };
+  serializer s(buffer, sizeof(buffer));
+  s.v<uint16_t>(1).v<uint16_t>(2);
+  CHECK(s.pos == 2);
+  CHECK(s.errcode == ERR_BUFFER_OVERFLOW);
+  deserializer ds(buffer, sizeof(buffer));
+  uint32_t value = 0;
+  ds.v<uint32_t>(value);
+  CHECK(ds.pos == 0);
+  CHECK(ds.errcode == ERR_BUFFER_OVERRUN); }
+
+TEST(serializer_unit_tests, string_after_value)
+{ char buffer[6] = { 0 };
+  serializer s(buffer, sizeof(buffer));
+  s.v<char>('x').s("ab");
+  CHECK(s.pos == 4);
+  char expected[6] = { 'x', 'a', 'b', 0, 0, 0 };
+  MEMCMP_EQUAL(expected, buffer, sizeof(buffer));
+  deserializer ds(buffer, sizeof(buffer));
+  char c = 0;
+  char str[4] = { 0 };
+  ds.v<char>(c).s(str, sizeof(str));
+  STRCMP_EQUAL("ab", str);
+  CHECK(ds.pos == 4); }
+
+TEST(serializer_unit_tests, varint)
+{ uint8_t buffer[32] = { 0 };
+  serializer s(buffer, sizeof(buffer));
+  s.var(0).var(127).var(300).var(0xFFFFFFFFFFFFFFFFULL);
+  CHECK(s.errcode == ERR_OK);
+  CHECK(s.pos == 1 + 1 + 2 + 10);
+  uint8_t expected[] = { 0x00, 0x7F, 0xAC, 0x02 };
+  MEMCMP_EQUAL(expected, buffer, sizeof(expected));
+  CHECK(buffer[13] == 0x01);
+  deserializer ds(buffer, s.pos);
+  uint8_t a = 1;
+  uint8_t b = 0;
+  uint16_t c = 0;
+  uint64_t d = 0;
+  ds.var<uint8_t>(a).var<uint8_t>(b).var<uint16_t>(c).var<uint64_t>(d);
+  CHECK(ds.errcode == ERR_OK);
+  CHECK(a == 0);
+  CHECK(b == 127);
+  CHECK(c == 300);
+  CHECK(d == 0xFFFFFFFFFFFFFFFFULL);
+  CHECK(ds.pos == s.pos); }
+
+TEST(serializer_unit_tests, varint_errors)
+{ uint8_t buffer[12] = { 0xAC, 0x02, 0x80 };
+  deserializer ds(buffer, 3);
+  uint8_t small = 0;
+  ds.var<uint8_t>(small);
+  CHECK(ds.errcode == ERR_INVALID_DATA);
+  CHECK(ds.pos == 0);
+  deserializer cut(buffer + 2, 1);
+  uint32_t value = 0;
+  cut.var<uint32_t>(value);
+  CHECK(cut.errcode == ERR_BUFFER_OVERRUN);
+  memset(buffer, 0xFF, sizeof(buffer));
+  deserializer lng(buffer, sizeof(buffer));
+  uint64_t big = 0;
+  lng.var<uint64_t>(big);
+  CHECK(lng.errcode == ERR_INVALID_DATA);
+  serializer s(buffer, 1);
+  s.var(128);
+  CHECK(s.errcode == ERR_BUFFER_OVERFLOW);
+  CHECK(s.pos == 0); }
+
+TEST(serializer_unit_tests, zigzag)
+{ CHECK(zigzag_encode(0) == 0);
+  CHECK(zigzag_encode(-1) == 1);
+  CHECK(zigzag_encode(1) == 2);
+  CHECK(zigzag_encode(-64) == 127);
+  CHECK(zigzag_decode(zigzag_encode(INT64_MIN)) == INT64_MIN);
+  uint8_t buffer[16] = { 0 };
+  serializer s(buffer, sizeof(buffer));
+  s.zz(-1).zz(63).zz(-300);
+  CHECK(s.pos == 1 + 1 + 2);
+  deserializer ds(buffer, s.pos);
+  int8_t a = 0;
+  int8_t b = 0;
+  int16_t c = 0;
+  ds.zz<int8_t>(a).zz<int8_t>(b).zz<int16_t>(c);
+  CHECK(ds.errcode == ERR_OK);
+  CHECK(a == -1);
+  CHECK(b == 63);
+  CHECK(c == -300);
+  deserializer narrow(buffer + 2, 2);
+  narrow.zz<int8_t>(a);
+  CHECK(narrow.errcode == ERR_INVALID_DATA); }
+
+TEST(serializer_unit_tests, bit_fields)
+{ uint8_t buffer[8] = { 0 };
+  serializer s(buffer, sizeof(buffer));
+  s.b(1, 1).b(5, 3).b(0xAB, 8).b(0x3, 2).v<uint8_t>(0x77).b(0x1FF, 9);
+  CHECK(s.errcode == ERR_OK);
+  CHECK(s.pos == 5);
+  uint8_t expected[] = { 0xBB, 0x3A, 0x77, 0xFF, 0x01 };
+  MEMCMP_EQUAL(expected, buffer, sizeof(expected));
+  deserializer ds(buffer, s.pos);
+  bool flag = false;
+  uint8_t mode = 0;
+  uint8_t code = 0;
+  uint8_t tail = 0;
+  uint8_t marker = 0;
+  uint16_t wide = 0;
+  ds.b<bool>(flag, 1).b<uint8_t>(mode, 3).b<uint8_t>(code, 8)
+  .b<uint8_t>(tail, 2).v<uint8_t>(marker).b<uint16_t>(wide, 9);
+  CHECK(ds.errcode == ERR_OK);
+  CHECK(flag);
+  CHECK(mode == 5);
+  CHECK(code == 0xAB);
+  CHECK(tail == 3);
+  CHECK(marker == 0x77);
+  CHECK(wide == 0x1FF);
+  CHECK(ds.pos == 5); }
+
+TEST(serializer_unit_tests, bit_field_errors)
+{ uint8_t buffer[1] = { 0 };
+  serializer s(buffer, sizeof(buffer));
+  s.b(0x7F, 7).b(0x3, 2);
+  CHECK(s.errcode == ERR_BUFFER_OVERFLOW);
+  CHECK(s.pos == 1);
+  CHECK(buffer[0] == 0x7F);
+  serializer w(buffer, sizeof(buffer));
+  w.b(0, 33);
+  CHECK(w.errcode == ERR_INVALID_ARGUMENT);
+  deserializer ds(buffer, sizeof(buffer));
+  uint8_t value = 0;
+  ds.b<uint8_t>(value, 4).b<uint8_t>(value, 5);
+  CHECK(ds.errcode == ERR_BUFFER_OVERRUN);
+  CHECK(value == 0xF); }
+
+/** \brief compare typed array with element by element serialization
+ *
+ *  \tparam TYPE type of the elements */
+template <typename TYPE>
+static void check_typed_array()
+{ TYPE values[37];
+  uint8_t* raw = (uint8_t*)values;
+
+  for (uint32_t i = 0; i < sizeof(values); i++) { raw[i] = (uint8_t)(i * 13); }
+
+  uint8_t expected[sizeof(values)] = { 0 };
+  uint8_t buffer[sizeof(values)] = { 0 };
+  serializer ref(expected, sizeof(expected));
+  serializer s(buffer, sizeof(buffer));
+  ref.hn();
+  s.hn();
+
+  for (uint32_t i = 0; i < 37; i++) { ref.v<TYPE>(values[i]); }
+
+  s.av<TYPE>(values, 37);
+  CHECK(s.errcode == ERR_OK);
+  CHECK(s.pos == sizeof(values));
+  MEMCMP_EQUAL(expected, buffer, sizeof(buffer));
+  TYPE back[37];
+  deserializer ds(buffer, sizeof(buffer));
+  ds.hn().av<TYPE>(back, 37);
+  CHECK(ds.errcode == ERR_OK);
+  MEMCMP_EQUAL(values, back, sizeof(values)); }
+
+TEST(serializer_unit_tests, typed_array_swapped)
+{ check_typed_array<uint16_t>();
+  check_typed_array<int32_t>();
+  check_typed_array<float>();
+  check_typed_array<uint64_t>(); }
+
+TEST(serializer_unit_tests, typed_array_straight_and_overflow)
+{ uint16_t values[3] = { 0x0102, 0x0304, 0x0506 };
+  uint8_t buffer[5] = { 0 };
+  serializer s(buffer, sizeof(buffer));
+  s.av<uint16_t>(values, 2);
+  MEMCMP_EQUAL(values, buffer, 4);
+  s.av<uint16_t>(values, 1);
+  CHECK(s.errcode == ERR_BUFFER_OVERFLOW);
+  CHECK(s.pos == 4);
+  uint16_t back[3] = { 0 };
+  deserializer ds(buffer, sizeof(buffer));
+  ds.av<uint16_t>(back, 3);
+  CHECK(ds.errcode == ERR_BUFFER_OVERRUN);
+  CHECK(back[0] == 0); }
+
+TEST(serializer_unit_tests, odd_size_elements_swapped)
+{ uint8_t data[6] = { 1, 2, 3, 4, 5, 6 };
+  byte_swap_copy(data, data, 3, 2);
+  uint8_t expected[6] = { 3, 2, 1, 6, 5, 4 };
+  MEMCMP_EQUAL(expected, data, sizeof(data)); }
+
+TEST(serializer_unit_tests, record_view)
+{ uint8_t buffer[16] = { 0 };
+  serializer s(buffer, sizeof(buffer));
+  s.be<uint16_t>(0x1234).le<uint32_t>(0xCAFE).v<uint8_t>(2);
+  s.v<uint8_t>(0xA1).v<uint8_t>(0xA2);
+  deserializer ds(buffer, s.pos);
+  uint16_t addr = 0;
+  uint32_t value = 0;
+  uint8_t count = 0;
+  deserializer_view rec = ds.view(7);
+  CHECK(rec);
+  rec.be<uint16_t>(addr).le<uint32_t>(value).v<uint8_t>(count);
+  CHECK(addr == 0x1234);
+  CHECK(value == 0xCAFE);
+  CHECK(count == 2);
+  CHECK(rec.pos == rec.size);
+  CHECK(ds.pos == 7);
+  uint8_t tail[2] = { 0 };
+  ds.a(tail, count);
+  CHECK(ds.errcode == ERR_OK);
+  CHECK(tail[1] == 0xA2); }
+
+TEST(serializer_unit_tests, truncated_record)
+{ uint8_t buffer[6] = { 0 };
+  deserializer ds(buffer, sizeof(buffer));
+  deserializer_view rec = ds.view(7);
+  CHECK(!rec);
+  CHECK(ds.errcode == ERR_BUFFER_OVERRUN);
+  CHECK(ds.pos == 0); }
+
+TEST(serializer_unit_tests, truncated_tail_after_record)
+{ uint8_t buffer[5] = { 0x00, 0x01, 0x03, 0xA1, 0xA2 };
+  deserializer ds(buffer, sizeof(buffer));
+  uint16_t addr = 0;
+  uint8_t count = 0;
+  deserializer_view rec = ds.view(3);
+  CHECK(rec);
+  rec.be<uint16_t>(addr).v<uint8_t>(count);
+  uint8_t tail[3] = { 0 };
+  ds.a(tail, count);
+  CHECK(addr == 1);
+  CHECK(ds.errcode == ERR_BUFFER_OVERRUN);
+  CHECK(ds.pos == 3); }
+
 int main(int argc, char** argv)
 { return CommandLineTestRunner::RunAllTests(argc, argv); }
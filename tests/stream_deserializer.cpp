@@ -0,0 +1,147 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include "tools/stream_deserializer.hpp"
+#include "core/errcode.hpp"
+#include <cstdint>
+#include <cstring>
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+
+TEST_GROUP(stream_deserializer_unit_tests)
+{ void setup() {}
+  void teardown() {} };
+
+TEST(stream_deserializer_unit_tests, chain)
+{ uint8_t first[] = { 0x12, 0x34, 0x56 };
+  uint8_t second[] = { 0x78 };
+  uint8_t third[] = { 0x9A, 0xBC };
+  stream_deserializer in;
+  in.add(first, sizeof(first)).add(second, sizeof(second));
+  in.add(third, sizeof(third));
+  uint16_t a = 0;
+  uint32_t b = 0;
+  in.be<uint16_t>(a).be<uint32_t>(b);
+  CHECK(in.errcode == ERR_OK);
+  CHECK(a == 0x1234);
+  CHECK(b == 0x56789ABC);
+  CHECK(in.available() == 0); }
+
+TEST(stream_deserializer_unit_tests, too_many_pieces)
+{ uint8_t data[] = { 1 };
+  stream_deserializer in;
+
+  for (uint32_t i = 0; i < STREAM_SEGMENTS; i++) { in.add(data, 1); }
+
+  CHECK(in.errcode == ERR_OK);
+  in.add(data, 1);
+  CHECK(in.errcode == ERR_BUFFER_OVERFLOW); }
+
+TEST(stream_deserializer_unit_tests, wrapped_ring)
+{ circular_buffer_static<uint8_t, 8> ring;
+
+  for (uint8_t i = 0; i < 6; i++) { ring.push_head(i); }
+
+  ring.pop_tail(5);
+
+  for (uint8_t i = 0x10; i < 0x16; i++) { ring.push_head(i); }
+
+  stream_deserializer in;
+  in.add(ring);
+  CHECK(in.available() == 7);
+  uint8_t kind = 0;
+  uint32_t value = 0;
+  in.v<uint8_t>(kind).le<uint32_t>(value);
+  CHECK(kind == 5);
+  CHECK(value == 0x13121110);
+  CHECK(ring.pop_tail(in.commit()) == 5);
+  CHECK(ring.memory_used() == 2);
+  CHECK(*ring.fetch_tail() == 0x14); }
+
+TEST(stream_deserializer_unit_tests, incomplete_message)
+{ uint8_t data[] = { 0x01, 0x02, 0x03 };
+  stream_deserializer in;
+  in.add(data, sizeof(data));
+  uint8_t a = 0;
+  uint32_t b = 0;
+  in.v<uint8_t>(a).be<uint32_t>(b);
+  CHECK(in.errcode == ERR_NOT_READY);
+  CHECK(in.pos == 1);
+  in.rollback();
+  CHECK(in.errcode == ERR_OK);
+  CHECK(in.pos == 0);
+  CHECK(in.commit() == 0); }
+
+TEST(stream_deserializer_unit_tests, resume_from_pipe)
+{ pipe<16> p;
+  uint8_t stage[8];
+  stream_deserializer in(stage, sizeof(stage));
+  uint8_t message[] = { 0xAB, 0x00, 0x00, 0x01, 0x02, 0xCD, 0x00, 0x00 };
+  uint8_t kind = 0;
+  uint32_t value = 0;
+
+  p.write(message, 3);
+  CHECK(in.pull(p) == 3);
+  in.v<uint8_t>(kind).be<uint32_t>(value);
+  CHECK(in.errcode == ERR_NOT_READY);
+  in.rollback();
+
+  p.write(message + 3, 5);
+  CHECK(in.pull(p) == 5);
+  in.v<uint8_t>(kind).be<uint32_t>(value);
+  CHECK(in.errcode == ERR_OK);
+  CHECK(kind == 0xAB);
+  CHECK(value == 0x0102);
+  CHECK(in.commit() == 5);
+
+  // the rest of the second message is moved to the start of the stage
+  uint8_t tail[] = { 0x03, 0x04 };
+  p.write(tail, sizeof(tail));
+  CHECK(in.pull(p) == 2);
+  CHECK(in.pos == 0);
+  in.v<uint8_t>(kind).be<uint32_t>(value);
+  CHECK(in.errcode == ERR_OK);
+  CHECK(kind == 0xCD);
+  CHECK(value == 0x0304); }
+
+TEST(stream_deserializer_unit_tests, pull_needs_stage)
+{ pipe<4> p;
+  uint8_t data[] = { 1 };
+  stream_deserializer in;
+  in.add(data, sizeof(data));
+  CHECK(in.pull(p) == 0);
+  CHECK(in.errcode == ERR_INVALID_ARGUMENT); }
+
+TEST(stream_deserializer_unit_tests, message_larger_than_stage)
+{ pipe<16> p;
+  uint8_t stage[4];
+  stream_deserializer in(stage, sizeof(stage));
+  uint8_t message[] = { 0xAB, 0x00, 0x00, 0x01, 0x02 };
+  uint8_t kind = 0;
+  uint32_t value = 0;
+
+  p.write(message, sizeof(message));
+  CHECK(in.pull(p) == 4);
+  in.v<uint8_t>(kind).be<uint32_t>(value);
+  CHECK(in.errcode == ERR_NOT_READY);
+  in.rollback();
+  CHECK(in.pull(p) == 0);
+  CHECK(in.errcode == ERR_BUFFER_OVERFLOW);
+  in.v<uint8_t>(kind);
+  CHECK(in.errcode == ERR_BUFFER_OVERFLOW); }
+
+TEST(stream_deserializer_unit_tests, skip_and_array)
+{ uint8_t first[] = { 1, 2, 3 };
+  uint8_t second[] = { 4, 5, 6 };
+  stream_deserializer in;
+  in.add(first, sizeof(first)).add(second, sizeof(second));
+  uint8_t out[3] = { 0 };
+  in.skip(2).a(out, sizeof(out));
+  uint8_t expected[] = { 3, 4, 5 };
+  MEMCMP_EQUAL(expected, out, sizeof(out));
+  CHECK(in.available() == 1); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
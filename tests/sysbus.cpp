@@ -0,0 +1,570 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstring>
+#include "bsp/bsp.h"
+#include "core/errcode.hpp"
+#include "core/sysbus.hpp"
+#include "io/print.hpp"
+
+uint8_t bus_output[128] = { 0 };
+uint32_t bus_counter = 0;
+uint32_t bus_blocks = 0;
+bool bus_auto_done = true;
+uint32_t timestamp = 0;
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+void bsp_tx_char(char ch) { (void)ch; }
+uint32_t bsp_timestamp() { return timestamp; }
+
+void bsp_sysbus_tx(uint8_t byte)
+{ if (bus_counter >= sizeof(bus_output)) { return; }
+
+  bus_output[bus_counter] = byte;
+  bus_counter++; }
+
+void bsp_sysbus_tx_block(const uint8_t* data, uint32_t len)
+{ for (uint32_t i = 0; i < len; i++) { bsp_sysbus_tx(data[i]); }
+
+  bus_blocks++;
+
+  if (bus_auto_done) { bsp_sysbus_tx_done_cb(); } }
+
+class test_node : public i_sysbus_node
+{ public:
+    explicit test_node(uint8_t address) : size(0), src(0), calls(0), cost(0)
+    { addr = address; memset(data, 0, sizeof(data)); }
+
+    virtual void handler(uint8_t* data, uint8_t size, uint16_t src) override
+    { memcpy(this->data, data, size);
+      this->size = size;
+      this->src = src;
+      timestamp += cost;
+      calls++; }
+
+    uint8_t data[SYSBUS_MESSAGE_SIZE];
+    uint8_t size;
+    uint16_t src;
+    uint32_t calls;
+    uint32_t cost; };
+
+/** \brief another device, it keeps transmitted bytes */
+class capture_bus : public sysbus
+{ public:
+    capture_bus() : len(0) {}
+
+    virtual void tx(const uint8_t* data, uint32_t len) override
+    { memcpy(&out[this->len], data, len);
+      this->len += len;
+      tx_done(); }
+
+    uint8_t out[256];
+    uint32_t len; };
+
+test_node node_a(0x10);
+test_node node_b(0x11);
+capture_bus remote_bus;
+test_node sender(0x40);
+
+/** \brief valid frame from 0x20 to 0x10 with ttl 3 and payload 1, 2, 3 */
+uint8_t frame_to_a[] = { 0x10, 0x20, 0x33, 0x01, 0x02, 0x03, 0x8E };
+
+/** \brief valid frame from 0x20 to remote 0x30 with ttl 2 and payload 0xAA */
+uint8_t frame_to_remote[] = { 0x30, 0x20, 0x12, 0xAA, 0x19 };
+
+void put(uint8_t* data, uint32_t size)
+{ for (uint32_t i = 0; i < size; i++) { bsp_sysbus_rx_cb(data[i]); } }
+
+TEST_GROUP(sysbus_tests)
+{ void setup()
+  { memset(bus_output, 0, sizeof(bus_output));
+    bus_counter = 0;
+    bus_blocks = 0;
+    bus_auto_done = true;
+    system_bus.parser.reset();
+
+    while (system_bus.rx_queue.pop_tail()) {}
+
+    for (uint8_t prio = 0; prio < SYSBUS_PRIORITIES; prio++)
+    { while (system_bus.tx_queue[prio].pop_tail()) {}
+
+      system_bus.limit[prio] = SYSBUS_TX_QUEUE;
+      system_bus.weight[prio] = 0;
+      system_bus.credit[prio] = 0; }
+
+    system_bus.tx_busy = false;
+    system_bus.polled = 0;
+    system_bus.forget();
+
+    for (sysbus_reassembly& slot : system_bus.slots) { slot.busy = false; }
+
+    remote_bus.len = 0;
+    sender.bus = &remote_bus;
+
+    node_a.calls = 0;
+    node_b.calls = 0;
+    node_a.cost = 0;
+    node_a.timing.reset();
+    system_bus.stats.reset();
+    system_bus.parser.errors = 0;
+    node_a.groups = 0;
+    node_b.groups = 0; }
+
+  void teardown() {} };
+
+TEST(sysbus_tests, parser_complete_frame)
+{ sysbus_parser p;
+
+  for (uint32_t i = 0; i < sizeof(frame_to_a) - 1; i++)
+  { CHECK(!p.put(frame_to_a[i])); }
+
+  CHECK(p.put(frame_to_a[sizeof(frame_to_a) - 1]));
+  CHECK(p.frame.dst == 0x10);
+  CHECK(p.frame.src == 0x20);
+  CHECK(p.frame.size == 3);
+  CHECK(p.frame.ttl == 3);
+  uint8_t expected[3] = { 0x01, 0x02, 0x03 };
+  MEMCMP_EQUAL(expected, p.frame.data, sizeof(expected)); }
+
+TEST(sysbus_tests, parser_resync_after_garbage)
+{ sysbus_parser p;
+  uint8_t garbage[] = { 0x55, 0xF0, 0x13, 0x00 };
+  uint32_t frames = 0;
+
+  for (uint32_t i = 0; i < sizeof(garbage); i++)
+  { frames += p.put(garbage[i]); }
+
+  for (uint32_t i = 0; i < sizeof(frame_to_a); i++)
+  { frames += p.put(frame_to_a[i]); }
+
+  CHECK(frames == 1);
+  CHECK(p.frame.dst == 0x10);
+  CHECK(p.frame.size == 3); }
+
+TEST(sysbus_tests, parser_drops_corrupted_frame)
+{ sysbus_parser p;
+  uint8_t corrupted[sizeof(frame_to_a)];
+  memcpy(corrupted, frame_to_a, sizeof(corrupted));
+  corrupted[4] ^= 0x40;
+  uint32_t frames = 0;
+
+  for (uint32_t i = 0; i < sizeof(corrupted); i++)
+  { frames += p.put(corrupted[i]); }
+
+  for (uint32_t i = 0; i < sizeof(frame_to_remote); i++)
+  { frames += p.put(frame_to_remote[i]); }
+
+  CHECK(frames == 1);
+  CHECK(p.frame.dst == 0x30); }
+
+TEST(sysbus_tests, parser_ignores_frames_inside_payload)
+{ sysbus_parser p;
+  uint8_t inner[] = { 0x10, 0x20, 0x00, 0x00 };
+  inner[3] = sysbus_csum::calc(inner, 3);
+  uint8_t frame[] = { 0x30, 0x20, 0x52, 0x00, inner[0], inner[1], inner[2],
+                      inner[3], 0x00 };
+  frame[8] = sysbus_csum::calc(frame, 8);
+  uint32_t frames = 0;
+
+  for (uint32_t i = 0; i < sizeof(frame_to_a); i++)
+  { frames += p.put(frame_to_a[i]); }
+
+  for (uint32_t n = 0; n < 2; n++)
+  { for (uint32_t i = 0; i < sizeof(frame); i++)
+    { if (p.put(frame[i]))
+      { frames++;
+        CHECK(i == sizeof(frame) - 1);
+        CHECK(p.frame.dst == 0x30);
+        CHECK(p.frame.size == 5); } } }
+
+  CHECK(frames == 3); }
+
+TEST(sysbus_tests, rx_is_deferred_to_poll)
+{ put(frame_to_a, sizeof(frame_to_a));
+  CHECK(node_a.calls == 0);
+  CHECK(system_bus.rx_queue.memory_used() == 1);
+  system_bus.poll();
+  CHECK(node_a.calls == 1);
+  CHECK(node_a.size == 3);
+  CHECK(node_a.src == 0x20);
+  CHECK(system_bus.rx_queue.memory_used() == 0); }
+
+TEST(sysbus_tests, remote_frame_retranslated)
+{ put(frame_to_remote, sizeof(frame_to_remote));
+  system_bus.poll();
+  uint8_t expected[] = { 0x30, 0x20, 0x11, 0xAA, 0x26 };
+  CHECK(bus_counter == sizeof(expected));
+  MEMCMP_EQUAL(expected, bus_output, sizeof(expected));
+  CHECK(node_a.calls == 0);
+  CHECK(node_b.calls == 0); }
+
+TEST(sysbus_tests, local_signal)
+{ uint8_t data[2] = { 0x12, 0x34 };
+  node_a.signal(data, sizeof(data), node_b.addr, 1);
+  CHECK(node_b.calls == 1);
+  CHECK(node_b.src == node_a.addr);
+  MEMCMP_EQUAL(data, node_b.data, sizeof(data));
+  CHECK(bus_counter == 0); }
+
+TEST(sysbus_tests, remote_signal_sent_by_one_block)
+{ uint8_t data[4] = { 1, 2, 3, 4 };
+  node_a.signal(data, sizeof(data), 0x30, 2);
+  CHECK(bus_blocks == 1);
+  CHECK(bus_counter == SYSBUS_HEADER_SIZE + sizeof(data) + SYSBUS_CSUM_SIZE);
+  CHECK(bus_output[0] == 0x30);
+  CHECK(bus_output[1] == node_a.addr);
+  CHECK(bus_output[2] == 0x41); }
+
+TEST(sysbus_tests, waiting_frames_coalesced)
+{ uint8_t data[2] = { 1, 2 };
+  bus_auto_done = false;
+  node_a.signal(data, sizeof(data), 0x30, 2);
+  node_a.signal(data, sizeof(data), 0x31, 2);
+  node_a.signal(data, sizeof(data), 0x32, 2);
+  CHECK(bus_blocks == 1);
+  CHECK(system_bus.tx_queue[SYSBUS_PRIORITY_NORMAL].memory_used() == 2);
+  system_bus.poll();
+  CHECK(bus_blocks == 1);
+  bsp_sysbus_tx_done_cb();
+  system_bus.poll();
+  CHECK(bus_blocks == 2);
+  CHECK(bus_counter == 3 * (SYSBUS_HEADER_SIZE + 2 + SYSBUS_CSUM_SIZE));
+  CHECK(system_bus.tx_queue[SYSBUS_PRIORITY_NORMAL].memory_used() == 0);
+  sysbus_parser p;
+  uint32_t frames = 0;
+
+  for (uint32_t i = 0; i < bus_counter; i++)
+  { frames += p.put(bus_output[i]); }
+
+  CHECK(frames == 3);
+  CHECK(p.frame.dst == 0x32); }
+
+TEST(sysbus_tests, broadcast_signal)
+{ uint8_t data[1] = { 0x55 };
+  node_a.signal(data, sizeof(data), SYSBUS_BROADCAST, 3);
+  CHECK(node_a.calls == 0);
+  CHECK(node_b.calls == 1);
+  CHECK(node_b.src == node_a.addr);
+  CHECK(bus_blocks == 1);
+  CHECK(bus_output[0] == SYSBUS_BROADCAST); }
+
+TEST(sysbus_tests, group_frame_from_bus)
+{ node_a.subscribe(1);
+  uint8_t frame[] = { SYSBUS_GROUP(1), 0x20, 0x13, 0x77, 0x00 };
+  frame[4] = sysbus_csum::calc(frame, 4);
+  put(frame, sizeof(frame));
+  system_bus.poll();
+  CHECK(node_a.calls == 1);
+  CHECK(node_b.calls == 0);
+  CHECK(bus_blocks == 1);
+  CHECK(bus_output[0] == SYSBUS_GROUP(1));
+  CHECK(bus_output[2] == 0x12); }
+
+TEST(sysbus_tests, group_frame_returned_to_sender)
+{ node_b.subscribe(2);
+  uint8_t frame[] = { SYSBUS_GROUP(2), 0x10, 0x13, 0x77, 0x00 };
+  frame[4] = sysbus_csum::calc(frame, 4);
+  put(frame, sizeof(frame));
+  system_bus.poll();
+  CHECK(node_b.calls == 0);
+  CHECK(bus_blocks == 0); }
+
+TEST(sysbus_tests, zero_ttl_frame_is_not_retranslated)
+{ uint8_t frame[] = { 0x10, 0x20, 0x00, 0x00 };
+  frame[3] = sysbus_csum::calc(frame, 3);
+  put(frame, sizeof(frame));
+  frame[0] = 0x30;
+  frame[3] = sysbus_csum::calc(frame, 3);
+  put(frame, sizeof(frame));
+  system_bus.poll();
+  CHECK(node_a.calls == 1);
+  CHECK(bus_blocks == 0); }
+
+TEST(sysbus_tests, oversized_signal_dropped)
+{ uint8_t data[SYSBUS_MESSAGE_SIZE + 1] = { 0 };
+  node_a.signal(data, sizeof(data), 0x30, 2);
+  CHECK(bus_counter == 0); }
+
+TEST(sysbus_tests, large_local_signal_not_fragmented)
+{ uint8_t data[SYSBUS_MESSAGE_SIZE];
+
+  for (uint32_t i = 0; i < sizeof(data); i++) { data[i] = (uint8_t)i; }
+
+  node_a.signal(data, sizeof(data), node_b.addr, 2);
+  CHECK(node_b.calls == 1);
+  CHECK(node_b.size == sizeof(data));
+  MEMCMP_EQUAL(data, node_b.data, sizeof(data));
+  CHECK(bus_counter == 0); }
+
+TEST(sysbus_tests, large_remote_signal_fragmented)
+{ uint8_t data[40] = { 0 };
+  node_a.signal(data, sizeof(data), 0x30, 2);
+  sysbus_parser p;
+  uint32_t frames = 0;
+
+  for (uint32_t i = 0; i < bus_counter; i++)
+  { if (p.put(bus_output[i]))
+    { CHECK(p.frame.fragment);
+      CHECK(p.frame.dst == 0x30);
+      CHECK(p.frame.ttl == 1);
+      CHECK((p.frame.data[0] & 0x0F) == frames);
+      frames++; } }
+
+  CHECK(frames == 3); }
+
+TEST(sysbus_tests, fragment_marked_by_size)
+{ uint8_t data[SYSBUS_FRAGMENT_SIZE] = { 0 };
+  node_a.signal(data, sizeof(data), 0x30, 2);
+  CHECK(bus_counter == 2 * SYSBUS_FRAME_SIZE);
+  CHECK((bus_output[2] >> 4) == SYSBUS_FRAGMENT_SIZE);
+  // fragment has the same checksum as any other frame
+  CHECK(sysbus_csum::calc(bus_output, SYSBUS_FRAME_SIZE - 1)
+        == bus_output[SYSBUS_FRAME_SIZE - 1]); }
+
+TEST(sysbus_tests, short_signal_not_fragmented)
+{ uint8_t data[SYSBUS_FRAGMENT_SIZE - 1] = { 0 };
+  node_a.signal(data, sizeof(data), 0x30, 2);
+  sysbus_parser p;
+  uint32_t frames = 0;
+
+  for (uint32_t i = 0; i < bus_counter; i++)
+  { if (p.put(bus_output[i]))
+    { CHECK(!p.frame.fragment);
+      CHECK(p.frame.size == sizeof(data));
+      frames++; } }
+
+  CHECK(frames == 1); }
+
+TEST(sysbus_tests, fragments_reassembled)
+{ uint8_t data[40];
+
+  for (uint32_t i = 0; i < sizeof(data); i++) { data[i] = (uint8_t)(i * 7); }
+
+  sender.signal(data, sizeof(data), node_a.addr, 2);
+  CHECK(remote_bus.len > 0);
+  put(remote_bus.out, remote_bus.len);
+  system_bus.poll();
+  CHECK(node_a.calls == 1);
+  CHECK(node_a.src == 0x40);
+  CHECK(node_a.size == sizeof(data));
+  MEMCMP_EQUAL(data, node_a.data, sizeof(data));
+  CHECK(bus_counter == 0);
+  CHECK(!system_bus.slots[0].busy); }
+
+TEST(sysbus_tests, remote_fragments_retranslated)
+{ uint8_t data[20] = { 0 };
+  sender.signal(data, sizeof(data), 0x30, 3);
+  put(remote_bus.out, remote_bus.len);
+  system_bus.poll();
+  CHECK(node_a.calls == 0);
+  CHECK(bus_counter == remote_bus.len);
+  CHECK(bus_output[2] == (remote_bus.out[2] - 1)); }
+
+TEST(sysbus_tests, incomplete_message_expires)
+{ uint8_t data[40] = { 0 };
+  sender.signal(data, sizeof(data), node_a.addr, 2);
+  // skip the last fragment
+  put(remote_bus.out, 2 * SYSBUS_FRAME_SIZE);
+  system_bus.poll();
+  CHECK(node_a.calls == 0);
+  CHECK(system_bus.slots[0].busy);
+  system_bus.polled = SYSBUS_REASSEMBLY_TIMEOUT;
+  system_bus.poll();
+  CHECK(!system_bus.slots[0].busy); }
+
+TEST(sysbus_tests, full_queue_reported)
+{ uint8_t data[2] = { 1, 2 };
+  bus_auto_done = false;
+  system_bus.limit[SYSBUS_PRIORITY_LOW] = 1;
+  // first frame goes to the bsp at once, second one waits in the queue
+  CHECK(node_a.signal(data, sizeof(data), 0x30, 2, SYSBUS_PRIORITY_LOW)
+        == ERR_OK);
+  CHECK(node_a.signal(data, sizeof(data), 0x30, 2, SYSBUS_PRIORITY_LOW)
+        == ERR_OK);
+  CHECK(node_a.signal(data, sizeof(data), 0x30, 2, SYSBUS_PRIORITY_LOW)
+        == ERR_BUSY);
+  CHECK(node_a.signal(data, sizeof(data), 0x30, 2, SYSBUS_PRIORITY_HIGH)
+        == ERR_OK);
+  uint8_t large[40] = { 0 };
+  CHECK(node_a.signal(large, sizeof(large), 0x30, 2, SYSBUS_PRIORITY_LOW)
+        == ERR_BUSY);
+  CHECK(node_a.signal(nullptr, 0, 0x30, 2) == ERR_INVALID_ARGUMENT); }
+
+TEST(sysbus_tests, high_priority_goes_first)
+{ uint8_t data[1] = { 0 };
+  bus_auto_done = false;
+  node_a.signal(data, sizeof(data), 0x30, 2, SYSBUS_PRIORITY_LOW);
+
+  for (uint8_t i = 0; i < 4; i++)
+  { node_a.signal(data, sizeof(data), 0x31, 2, SYSBUS_PRIORITY_LOW); }
+
+  node_a.signal(data, sizeof(data), 0x32, 2, SYSBUS_PRIORITY_HIGH);
+  uint32_t first = bus_counter;
+  bsp_sysbus_tx_done_cb();
+  system_bus.poll();
+  CHECK(bus_blocks == 2);
+  CHECK(bus_output[first] == 0x32); }
+
+TEST(sysbus_tests, weighted_queues_share_bus)
+{ uint8_t data[1] = { 0 };
+  bus_auto_done = false;
+  system_bus.weight[SYSBUS_PRIORITY_HIGH] = 1;
+  system_bus.weight[SYSBUS_PRIORITY_LOW] = 1;
+  node_a.signal(data, sizeof(data), 0x30, 2, SYSBUS_PRIORITY_LOW);
+
+  for (uint8_t i = 0; i < 2; i++)
+  { node_a.signal(data, sizeof(data), 0x31, 2, SYSBUS_PRIORITY_LOW);
+    node_a.signal(data, sizeof(data), 0x32, 2, SYSBUS_PRIORITY_HIGH); }
+
+  uint32_t first = bus_counter;
+  bsp_sysbus_tx_done_cb();
+  system_bus.poll();
+  uint32_t frame = SYSBUS_HEADER_SIZE + sizeof(data) + SYSBUS_CSUM_SIZE;
+  uint8_t expected[] = { 0x32, 0x31, 0x32, 0x31 };
+
+  for (uint32_t i = 0; i < sizeof(expected); i++)
+  { CHECK(bus_output[first + i * frame] == expected[i]); } }
+
+TEST(sysbus_tests, ring_size_learned)
+{ uint8_t data[1] = { 0 };
+  // the frame returns after 4 hops
+  uint8_t frame[] = { SYSBUS_BROADCAST, 0x10, 0x1B, 0x00, 0x00 };
+  frame[4] = sysbus_csum::calc(frame, 4);
+
+  for (uint32_t i = 0; i < SYSBUS_RETURNS; i++)
+  { CHECK(system_bus.ring == 0);
+    node_a.signal(data, sizeof(data), SYSBUS_BROADCAST, SYSBUS_TTL_MAX);
+    CHECK(bus_output[2] == 0x10 + SYSBUS_TTL_MAX - 1);
+    put(frame, sizeof(frame));
+    system_bus.poll(); }
+
+  CHECK(system_bus.ring == 4);
+  bus_counter = 0;
+  node_a.signal(data, sizeof(data), 0x30, SYSBUS_TTL_MAX);
+  CHECK(bus_output[2] == 0x13);
+  system_bus.polled = SYSBUS_ROUTE_TIMEOUT;
+  system_bus.poll();
+  CHECK(system_bus.ring == 0); }
+
+TEST(sysbus_tests, unreachable_destination_dropped)
+{ uint8_t data[1] = { 0 };
+  uint8_t frame[] = { 0x30, 0x10, 0x10, 0x00, 0x00 };
+  frame[4] = sysbus_csum::calc(frame, 4);
+
+  for (uint32_t i = 0; i < SYSBUS_RETURNS; i++)
+  { CHECK(node_a.signal(data, sizeof(data), 0x30, 1) == ERR_OK);
+    put(frame, sizeof(frame));
+    system_bus.poll(); }
+
+  bus_counter = 0;
+  CHECK(system_bus.route(0x30) != nullptr);
+  CHECK(!system_bus.route(0x30)->reachable);
+  CHECK(node_a.signal(data, sizeof(data), 0x30, 2) == ERR_UNREACHABLE);
+  CHECK(bus_counter == 0);
+  // address appeared on the ring
+  uint8_t reply[] = { 0x10, 0x30, 0x1C, 0x00, 0x00 };
+  reply[4] = sysbus_csum::calc(reply, 4);
+  put(reply, sizeof(reply));
+  system_bus.poll();
+  CHECK(system_bus.route(0x30)->reachable);
+  CHECK(system_bus.route(0x30)->hops == SYSBUS_TTL_MAX - 0x0C);
+  CHECK(node_a.signal(data, sizeof(data), 0x30, 2) == ERR_OK);
+  CHECK(bus_counter > 0); }
+
+TEST(sysbus_tests, noise_from_own_address_ignored)
+{ uint8_t data[1] = { 0 };
+  // valid checksum, but this frame was never sent
+  uint8_t noise[] = { 0x30, 0x10, 0x10, 0x5A, 0x00 };
+  noise[4] = sysbus_csum::calc(noise, 4);
+
+  for (uint32_t i = 0; i < SYSBUS_RETURNS; i++)
+  { CHECK(node_a.signal(data, sizeof(data), 0x30, 1) == ERR_OK);
+    put(noise, sizeof(noise));
+    system_bus.poll(); }
+
+  CHECK(system_bus.ring == 0);
+  CHECK(!system_bus.route(0x30) || system_bus.route(0x30)->reachable);
+  // one return of the real frame isn't enough
+  uint8_t frame[] = { 0x30, 0x10, 0x10, 0x00, 0x00 };
+  frame[4] = sysbus_csum::calc(frame, 4);
+  put(frame, sizeof(frame));
+  system_bus.poll();
+  CHECK(system_bus.ring == 0);
+  CHECK(system_bus.route(0x30)->reachable);
+  CHECK(node_a.signal(data, sizeof(data), 0x30, 1) == ERR_OK); }
+
+TEST(sysbus_tests, ring_not_shorter_than_live_source)
+{ uint8_t data[1] = { 0 };
+  // 0x30 is 5 hops away
+  uint8_t reply[] = { 0x10, 0x30, 0x1A, 0x00, 0x00 };
+  reply[4] = sysbus_csum::calc(reply, 4);
+  put(reply, sizeof(reply));
+  system_bus.poll();
+  // own frames return after 2 hops, which can't be
+  uint8_t frame[] = { SYSBUS_BROADCAST, 0x10, 0x1D, 0x00, 0x00 };
+  frame[4] = sysbus_csum::calc(frame, 4);
+
+  for (uint32_t i = 0; i < SYSBUS_RETURNS; i++)
+  { node_a.signal(data, sizeof(data), SYSBUS_BROADCAST, SYSBUS_TTL_MAX);
+    put(frame, sizeof(frame));
+    system_bus.poll(); }
+
+  CHECK(system_bus.ring == 6);
+  // and the farther source makes the ring longer
+  reply[1] = 0x31;
+  reply[2] = 0x17;
+  reply[4] = sysbus_csum::calc(reply, 4);
+  put(reply, sizeof(reply));
+  system_bus.poll();
+  CHECK(system_bus.ring == 9); }
+
+TEST(sysbus_tests, counters)
+{ put(frame_to_a, sizeof(frame_to_a));
+  put(frame_to_remote, sizeof(frame_to_remote));
+  uint8_t corrupted[sizeof(frame_to_a)];
+  memcpy(corrupted, frame_to_a, sizeof(corrupted));
+  corrupted[6] ^= 0x01;
+  put(corrupted, sizeof(corrupted));
+  system_bus.poll();
+  uint8_t expired[] = { 0x30, 0x20, 0x00, 0x00 };
+  expired[3] = sysbus_csum::calc(expired, 3);
+  put(expired, sizeof(expired));
+  system_bus.poll();
+  uint8_t data[SYSBUS_MESSAGE_SIZE + 1] = { 0 };
+  node_a.signal(data, sizeof(data), 0x30, 2);
+  CHECK(system_bus.stats.received == 3);
+  CHECK(system_bus.stats.delivered == 1);
+  CHECK(system_bus.stats.retranslated == 1);
+  CHECK(system_bus.stats.transmitted == 1);
+  CHECK(system_bus.stats.expired == 1);
+  CHECK(system_bus.stats.oversized == 1);
+  CHECK(system_bus.parser.errors == 1); }
+
+TEST(sysbus_tests, handler_time_histogram)
+{ uint8_t data[1] = { 0 };
+  node_a.cost = 5;
+  node_b.signal(data, sizeof(data), node_a.addr, 1);
+  node_a.cost = 100000;
+  node_b.signal(data, sizeof(data), node_a.addr, 1);
+  CHECK(node_a.timing.calls == 2);
+  CHECK(node_a.timing.buckets[3] == 1);
+  CHECK(node_a.timing.buckets[SYSBUS_HISTOGRAM - 1] == 1);
+  CHECK(node_a.timing.max == 100000); }
+
+TEST(sysbus_tests, report)
+{ uint8_t data[1] = { 0 };
+  node_a.cost = 5;
+  node_b.signal(data, sizeof(data), node_a.addr, 1);
+  char text[1024] = { 0 };
+  print out(text, sizeof(text) - 1);
+  system_bus.report(out);
+  CHECK(out.errcode == ERR_OK);
+  CHECK(strstr(text, "delivered       1\n") != nullptr);
+  CHECK(strstr(text, "node 16: 1 calls, max 5\n") != nullptr);
+  CHECK(strstr(text, "  <          8: 1\n") != nullptr); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
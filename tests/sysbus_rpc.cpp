@@ -0,0 +1,186 @@
+#include <CppUTest/CommandLineTestRunner.h>
+#include <CppUTest/TestHarness.h>
+#include <CppUTestExt/MockSupport.h>
+
+#include <cstdint>
+#include <cstring>
+#include "bsp/bsp.h"
+#include "core/errcode.hpp"
+#include "core/sysbus.hpp"
+#include "core/sysbus_rpc.hpp"
+
+uint8_t bus_output[512] = { 0 };
+uint32_t bus_counter = 0;
+
+void bsp_enter_critical() {}
+void bsp_leave_critical() {}
+
+void bsp_sysbus_tx(uint8_t byte)
+{ if (bus_counter >= sizeof(bus_output)) { return; }
+
+  bus_output[bus_counter] = byte;
+  bus_counter++; }
+
+void bsp_sysbus_tx_block(const uint8_t* data, uint32_t len)
+{ for (uint32_t i = 0; i < len; i++) { bsp_sysbus_tx(data[i]); }
+
+  bsp_sysbus_tx_done_cb(); }
+
+/** \brief another device, it keeps transmitted bytes */
+class capture_bus : public sysbus
+{ public:
+    capture_bus() : len(0) {}
+
+    virtual void tx(const uint8_t* data, uint32_t len) override
+    { memcpy(&out[this->len], data, len);
+      this->len += len;
+      tx_done(); }
+
+    uint8_t out[512];
+    uint32_t len; };
+
+/** \brief node that answers with incremented bytes of the request */
+class test_rpc_node : public i_sysbus_rpc_node
+{ public:
+    test_rpc_node(sysbus& bus, uint8_t address) : i_sysbus_rpc_node(bus),
+      answer(true), requests(0), responses(0), last_id(0), last_errcode(0),
+      last_size(0)
+    { addr = address; memset(last_data, 0, sizeof(last_data)); }
+
+    virtual void request(uint8_t id, uint8_t* data, uint8_t size,
+                         uint8_t src) override
+    { requests++;
+
+      if (!answer) { return; }
+
+      uint8_t result[SYSBUS_RPC_DATA_SIZE];
+
+      for (uint8_t i = 0; i < size; i++) { result[i] = data[i] + 1; }
+
+      reply(src, id, result, size); }
+
+    virtual void response(uint8_t id, uint8_t errcode, uint8_t* data,
+                          uint8_t size) override
+    { responses++;
+      last_id = id;
+      last_errcode = errcode;
+      last_size = size;
+
+      if (data) { memcpy(last_data, data, size); } }
+
+    bool answer;
+    uint32_t requests;
+    uint32_t responses;
+    uint8_t last_id;
+    uint8_t last_errcode;
+    uint8_t last_size;
+    uint8_t last_data[SYSBUS_RPC_DATA_SIZE]; };
+
+capture_bus remote_bus;
+test_rpc_node client(system_bus, 0x10);
+test_rpc_node local_server(system_bus, 0x11);
+test_rpc_node remote_server(remote_bus, 0x30);
+
+/** \brief move all of the transmitted bytes between the buses */
+void exchange()
+{ for (uint32_t i = 0; i < bus_counter; i++) { remote_bus.rx(bus_output[i]); }
+
+  bus_counter = 0;
+  remote_bus.poll();
+
+  for (uint32_t i = 0; i < remote_bus.len; i++)
+  { system_bus.rx(remote_bus.out[i]); }
+
+  remote_bus.len = 0;
+  system_bus.poll(); }
+
+TEST_GROUP(sysbus_rpc_tests)
+{ void setup()
+  { bus_counter = 0;
+    remote_bus.len = 0;
+    system_bus.polled = 0;
+    remote_bus.polled = 0;
+
+    for (sysbus_rpc_call& c : client.calls) { c.busy = false; }
+
+    client.responses = 0;
+    local_server.requests = 0;
+    remote_server.requests = 0;
+    remote_server.answer = true; }
+
+  void teardown() {} };
+
+TEST(sysbus_rpc_tests, local_call)
+{ uint8_t args[2] = { 1, 2 };
+  uint8_t id = 0;
+  CHECK(client.call(local_server.addr, args, sizeof(args), 10, &id)
+        == ERR_OK);
+  CHECK(local_server.requests == 1);
+  CHECK(client.responses == 1);
+  CHECK(client.last_id == id);
+  CHECK(client.last_errcode == ERR_OK);
+  CHECK(client.last_size == 2);
+  CHECK(client.last_data[0] == 2);
+  CHECK(client.last_data[1] == 3);
+  CHECK(client.pending() == 0);
+  CHECK(bus_counter == 0); }
+
+TEST(sysbus_rpc_tests, calls_in_flight)
+{ uint8_t ids[3] = { 0 };
+
+  for (uint8_t i = 0; i < 3; i++)
+  { CHECK(client.call(remote_server.addr, &i, 1, 10, &ids[i]) == ERR_OK); }
+
+  CHECK(ids[0] != ids[1]);
+  CHECK(ids[1] != ids[2]);
+  CHECK(client.pending() == 3);
+  CHECK(client.responses == 0);
+  exchange();
+  CHECK(remote_server.requests == 3);
+  CHECK(client.responses == 3);
+  CHECK(client.pending() == 0);
+  CHECK(client.last_id == ids[2]);
+  CHECK(client.last_data[0] == 3); }
+
+TEST(sysbus_rpc_tests, call_timeout)
+{ uint8_t args[1] = { 0 };
+  uint8_t id = 0;
+  remote_server.answer = false;
+  CHECK(client.call(remote_server.addr, args, sizeof(args), 10, &id)
+        == ERR_OK);
+  exchange();
+  CHECK(client.responses == 0);
+  system_bus.polled = 9;
+  system_bus.poll();
+  CHECK(client.responses == 0);
+  system_bus.polled = 10;
+  system_bus.poll();
+  CHECK(client.responses == 1);
+  CHECK(client.last_id == id);
+  CHECK(client.last_errcode == ERR_TIMEOUT);
+  CHECK(client.pending() == 0); }
+
+TEST(sysbus_rpc_tests, late_response_ignored)
+{ uint8_t args[1] = { 0 };
+  uint8_t id = 0;
+  CHECK(client.call(remote_server.addr, args, sizeof(args), 10, &id)
+        == ERR_OK);
+  client.cancel(id);
+  exchange();
+  CHECK(remote_server.requests == 1);
+  CHECK(client.responses == 0); }
+
+TEST(sysbus_rpc_tests, pending_table_full)
+{ uint8_t args[1] = { 0 };
+  remote_server.answer = false;
+
+  for (uint32_t i = 0; i < SYSBUS_RPC_PENDING; i++)
+  { CHECK(client.call(remote_server.addr, args, sizeof(args)) == ERR_OK);
+    exchange(); }
+
+  CHECK(client.call(remote_server.addr, args, sizeof(args)) == ERR_BUSY);
+  CHECK(client.call(SYSBUS_BROADCAST, args, sizeof(args))
+        == ERR_INVALID_ARGUMENT); }
+
+int main(int argc, char** argv)
+{ return CommandLineTestRunner::RunAllTests(argc, argv); }
@@ -0,0 +1,235 @@
+/** \file  crc.hpp
+ *  \brief cyclic redundancy check toolset
+ *  \details all of the lookup tables are generated by the compiler, so they
+ *           are placed in read-only memory and cost nothing at the runtime.
+ *           any polynomial of 8, 16 or 32 bit width can be used, most common
+ *           variants are predefined at the end of the file */
+
+#ifndef CRC_HPP
+#define CRC_HPP
+
+#include <cstdint>
+#include "core/pipe.hpp"
+
+/** \brief   reflects bit order of the value
+ *
+ *  \tparam TYPE type of the value
+ *  \param  val  value to reflect
+ *
+ *  \return reflected value */
+template <typename TYPE>
+constexpr TYPE crc_reflect(TYPE val)
+{ TYPE res = 0;
+
+  for (uint32_t i = 0; i < sizeof(TYPE) * 8; i++)
+  { res = (TYPE)((res << 1) | (val & 1));
+    val = (TYPE)(val >> 1); }
+
+  return res; }
+
+/** \brief   lookup tables for the crc calculation
+ *  \details first table is the classic byte-wise table. each next table
+ *           contains the crc of the byte followed by one more zero byte than
+ *           the previous one, it's used to process several bytes at once
+ *
+ *  \tparam TYPE    type of the crc register
+ *  \tparam POLY    polynomial in normal (not reflected) form
+ *  \tparam REFLECT bit order of the algorithm
+ *  \tparam SLICES  number of tables */
+template <typename TYPE, TYPE POLY, bool REFLECT, uint32_t SLICES>
+class crc_table
+{ public:
+    constexpr crc_table() : t()
+    { constexpr uint32_t width = sizeof(TYPE) * 8;
+      constexpr TYPE top = (TYPE)((TYPE)1 << (width - 1));
+
+      for (uint32_t i = 0; i < 256; i++)
+      { TYPE reg = 0;
+
+        if (REFLECT)
+        { reg = (TYPE)i;
+
+          for (uint32_t bit = 0; bit < 8; bit++)
+          { reg = (reg & 1) ? (TYPE)((reg >> 1) ^ crc_reflect<TYPE>(POLY))
+                  : (TYPE)(reg >> 1); } }
+        else
+        { reg = (TYPE)((TYPE)i << (width - 8));
+
+          for (uint32_t bit = 0; bit < 8; bit++)
+          { reg = (reg & top) ? (TYPE)((reg << 1) ^ POLY)
+                  : (TYPE)(reg << 1); } }
+
+        t[0][i] = reg; }
+
+      for (uint32_t s = 1; s < SLICES; s++)
+      { for (uint32_t i = 0; i < 256; i++)
+        { TYPE prev = t[s - 1][i];
+
+          if (REFLECT)
+          { t[s][i] = (TYPE)(t[0][prev & 0xFF] ^ (prev >> 8)); }
+          else
+          { t[s][i] = (TYPE)(t[0][(prev >> (width - 8)) & 0xFF]
+                             ^ (TYPE)(prev << 8)); } } } }
+
+    /** \brief tables itself */
+    TYPE t[SLICES][256]; };
+
+/** \brief   generic table-driven crc calculator
+ *  \details parameters follow the common catalogue notation. the crc can be
+ *           computed in one call or incrementally while the data arrives,
+ *           byte by byte or by chunks of any size
+ *
+ *  \tparam TYPE    type of the crc register, defines width of the crc
+ *  \tparam POLY    polynomial in normal (not reflected) form
+ *  \tparam INIT    initial value of the register
+ *  \tparam REFLECT true if input and output are reflected
+ *  \tparam XOROUT  value to xor with the final register
+ *  \tparam SLICES  number of bytes that processed per one step of bulk
+ *                  calculation, 1 for the classic algorithm, 4 or 8 for
+ *                  slice-by-N algorithm. note that every slice costs one more
+ *                  table of 256 entries */
+template <typename TYPE,
+          TYPE POLY,
+          TYPE INIT,
+          bool REFLECT,
+          TYPE XOROUT,
+          uint32_t SLICES = 1>
+class crc
+{ public:
+    static_assert(SLICES == 1 || SLICES >= sizeof(TYPE),
+                  "slice must be not less than width of the crc");
+
+    crc() : reg(start) {}
+
+    /** \brief start new calculation
+     *
+     *  \return reference to the current crc object */
+    crc& reset() { reg = start; return *this; }
+
+    /** \brief update the crc by one byte
+     *
+     *  \param byte next byte of the data
+     *
+     *  \return reference to the current crc object */
+    crc& put(uint8_t byte)
+    { if (REFLECT)
+      { reg = (TYPE)(table.t[0][(reg ^ byte) & 0xFF] ^ (reg >> 8)); }
+      else
+      { reg = (TYPE)(table.t[0][((reg >> (width - 8)) ^ byte) & 0xFF]
+                     ^ (TYPE)(reg << 8)); }
+
+      return *this; }
+
+    /** \brief update the crc by the chunk of data
+     *
+     *  \param data pointer to the data
+     *  \param len  length of the data
+     *
+     *  \return reference to the current crc object */
+    crc& put(const void* data, uint32_t len)
+    { const uint8_t* d = (const uint8_t*)data;
+
+      while (SLICES > 1 && len >= SLICES)
+      { TYPE res = 0;
+
+        for (uint32_t i = 0; i < SLICES; i++)
+        { uint8_t byte = d[i];
+
+          if (i < sizeof(TYPE))
+          { byte ^= (REFLECT) ? (uint8_t)(reg >> (i * 8))
+                    : (uint8_t)(reg >> (width - 8 - i * 8)); }
+
+          res ^= table.t[SLICES - 1 - i][byte]; }
+
+        reg = res;
+        d += SLICES; len -= SLICES; }
+
+      while (len) { put(*d); d++; len--; }
+
+      return *this; }
+
+    /** \brief get the result of the calculation
+     *  \note  calculation may be continued after that
+     *
+     *  \return crc value */
+    TYPE get() const
+    { return (TYPE)(reg ^ XOROUT); }
+
+    /** \brief calculate the crc of the data in one call
+     *
+     *  \param data pointer to the data
+     *  \param len  length of the data
+     *
+     *  \return crc value */
+    static TYPE calc(const void* data, uint32_t len)
+    { return crc().put(data, len).get(); }
+
+  private:
+    /** \brief width of the crc in bits */
+    static constexpr uint32_t width = sizeof(TYPE) * 8;
+
+    /** \brief start value of the register */
+    static constexpr TYPE start = (REFLECT) ? crc_reflect<TYPE>(INIT) : INIT;
+
+    /** \brief lookup tables */
+    static constexpr crc_table<TYPE, POLY, REFLECT, SLICES> table = {};
+
+    /** \brief current value of the register */
+    TYPE reg; };
+
+/** \brief   pipe that calculates crc of all of the written data
+ *  \details use it to check the data on the fly without extra pass over
+ *           the buffer
+ *
+ *  \tparam CRC    crc calculator
+ *  \tparam VOLUME size of data that can the pipe contain */
+template <typename CRC, uint32_t VOLUME>
+class crc_pipe : public pipe<VOLUME>
+{ public:
+    /** \brief write data chunk in pipe and update the crc
+     *
+     *  \param data pointer to data to write
+     *  \param size size of data to write
+     *
+     *  \return size of data that has been written */
+    virtual uint32_t write(void* data, uint32_t size) override
+    { uint32_t written = pipe<VOLUME>::write(data, size);
+
+      if (written) { sum.put(data, written); }
+
+      return written; }
+
+    /** \brief crc of the written data */
+    CRC sum; };
+
+/** \defgroup crc_variants
+ *  \brief    most common crc variants
+ *  \{ */
+
+/** \brief CRC-8, poly 0x07 */
+typedef crc<uint8_t, 0x07, 0x00, false, 0x00> crc8;
+
+/** \brief CRC-8/MAXIM (1-wire), poly 0x31 reflected */
+typedef crc<uint8_t, 0x31, 0x00, true, 0x00> crc8_maxim;
+
+/** \brief CRC-16/CCITT-FALSE, poly 0x1021 */
+typedef crc<uint16_t, 0x1021, 0xFFFF, false, 0x0000> crc16_ccitt;
+
+/** \brief CRC-16/XMODEM, poly 0x1021 with zero initial value */
+typedef crc<uint16_t, 0x1021, 0x0000, false, 0x0000> crc16_xmodem;
+
+/** \brief CRC-16/MODBUS, poly 0x8005 reflected */
+typedef crc<uint16_t, 0x8005, 0xFFFF, true, 0x0000> crc16_modbus;
+
+/** \brief CRC-32 (ethernet, zip), poly 0x04C11DB7 reflected */
+typedef crc<uint32_t, 0x04C11DB7, 0xFFFFFFFF, true, 0xFFFFFFFF> crc32;
+
+/** \brief CRC-32 with slice-by-4 bulk calculation, 4 KiB of tables */
+typedef crc<uint32_t, 0x04C11DB7, 0xFFFFFFFF, true, 0xFFFFFFFF, 4> crc32_s4;
+
+/** \brief CRC-32 with slice-by-8 bulk calculation, 8 KiB of tables */
+typedef crc<uint32_t, 0x04C11DB7, 0xFFFFFFFF, true, 0xFFFFFFFF, 8> crc32_s8;
+
+/** \} */
+
+#endif // CRC_HPP
@@ -0,0 +1,58 @@
+/** \file  dlog_decode.cpp
+ *  \brief host tool that prints the records of the deferred log
+ *  \details string table is collected from the firmware image, ELF file
+ *           or raw binary. -b is for the big endian device
+ *
+ *  usage: dlog_decode firmware [-b] < records.bin */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "tools/dlog_decoder.hpp"
+#include "core/errcode.hpp"
+
+void bsp_tx_char(char ch) { fputc(ch, stdout); }
+
+void bsp_tx_block(const char* data, uint32_t len)
+{ fwrite(data, 1, len, stdout); }
+
+void bsp_tx_flush() { fflush(stdout); }
+
+int main(int argc, char** argv)
+{ if (argc < 2)
+  { fprintf(stderr, "usage: %s firmware [-b] < records.bin\n", argv[0]);
+    return 1; }
+
+  FILE* f = fopen(argv[1], "rb");
+
+  if (!f)
+  { perror(argv[1]);
+    return 1; }
+
+  std::vector<char> image;
+  char chunk[4096];
+  size_t n;
+
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+  { image.insert(image.end(), chunk, chunk + n); }
+
+  fclose(f);
+  bool big = argc > 2 && !strcmp(argv[2], "-b");
+  static dlog_decoder decoder(image.data(), (uint32_t)image.size(), big);
+  std::vector<uint8_t> stream;
+  print out;
+
+  while ((n = fread(chunk, 1, sizeof(chunk), stdin)) > 0)
+  { stream.insert(stream.end(), chunk, chunk + n);
+    uint32_t used = decoder.decode(stream.data(), (uint32_t)stream.size(),
+                                   out);
+    stream.erase(stream.begin(), stream.begin() + used);
+
+    if (decoder.errcode != ERR_OK)
+    { out.flush();
+      fprintf(stderr, "broken stream or wrong firmware\n");
+      return 1; } }
+
+  out.flush();
+  return 0; }
@@ -0,0 +1,175 @@
+/** \file dlog_decoder.cpp
+ *  \brief implementation of the host side decoder of the deferred log */
+
+#include <cstdint>
+#include <cstring>
+#include "tools/dlog_decoder.hpp"
+#include "io/dlog.hpp"
+#include "core/errcode.hpp"
+
+dlog_decoder::dlog_decoder(const char* image, uint32_t size, bool big_endian)
+  : errcode(ERR_OK),
+    count(0),
+    big_endian(big_endian)
+{ const char* end = image + size;
+  const char* p = image;
+
+  while ((p = (const char*)memmem(p, end - p, DLOG_MAGIC, DLOG_MAGIC_SIZE)))
+  { p += DLOG_MAGIC_SIZE;
+    const char* codes_end = (const char*)memchr(p, '\0', end - p);
+
+    if (!codes_end) { break; }
+
+    const char* format_end = (const char*)memchr(codes_end + 1, '\0',
+                                                 end - codes_end - 1);
+
+    if (!format_end) { break; }
+
+    if (count == DLOG_DECODER_ENTRIES)
+    { errcode = ERR_BUFFER_OVERFLOW;
+      break; }
+
+    // insertion keeps the entries sorted, duplicates are skipped
+    uint32_t id = dlog_hash(p, (uint32_t)(format_end - p));
+    uint32_t i = count;
+
+    while (i && entries[i - 1].id > id)
+    { entries[i] = entries[i - 1];
+      i--; }
+
+    if (i && entries[i - 1].id == id)
+    { memmove(entries + i, entries + i + 1, (count - i) * sizeof(entry)); }
+    else
+    { entries[i].id = id;
+      entries[i].text = p;
+      count++; }
+
+    p = format_end + 1; } }
+
+const char* dlog_decoder::find(uint32_t id) const
+{ uint32_t lo = 0;
+  uint32_t hi = count;
+
+  while (lo < hi)
+  { uint32_t mid = (lo + hi) / 2;
+
+    if (entries[mid].id == id) { return entries[mid].text; }
+
+    if (entries[mid].id < id) { lo = mid + 1; }
+    else { hi = mid; } }
+
+  return nullptr; }
+
+uint32_t dlog_decoder::decode(const uint8_t* data, uint32_t size, print& out)
+{ uint32_t pos = 0;
+
+  while (pos < size && errcode == ERR_OK)
+  { uint32_t len = data[pos];
+
+    if (len < DLOG_HEADER)
+    { errcode = ERR_INVALID_DATA;
+      break; }
+
+    if (len > size - pos) { break; }
+
+    record(data + pos, len, out);
+    pos += len; }
+
+  return pos; }
+
+uint64_t dlog_decoder::integer(const uint8_t* p, uint32_t n) const
+{ uint64_t val = 0;
+
+  for (uint32_t i = 0; i < n; i++)
+  { val |= (uint64_t)p[(big_endian) ? n - 1 - i : i] << (8 * i); }
+
+  return val; }
+
+/** \brief size of the argument by its type code, 0 for the string */
+static uint32_t code_size(char code)
+{ switch (code)
+  { case 'b': case 'B': case 'c': return 1;
+
+    case 'h': case 'H':           return 2;
+
+    case 'i': case 'I': case 'f': return 4;
+
+    case 'q': case 'Q': case 'd': return 8;
+
+    default:                      return 0; } }
+
+/** \brief print the part of the format */
+static void literal(print& out, const char* str, uint32_t n)
+{ char piece[64];
+
+  while (n)
+  { uint32_t len = (n < sizeof(piece) - 1) ? n : sizeof(piece) - 1;
+    memcpy(piece, str, len);
+    piece[len] = '\0';
+    out(piece);
+    str += len;
+    n -= len; } }
+
+void dlog_decoder::record(const uint8_t* rec, uint32_t len, print& out)
+{ uint32_t id = (uint32_t)integer(rec + 1, 4);
+  const uint8_t* end = rec + len;
+  rec += DLOG_HEADER;
+
+  if (id == DLOG_DROPPED_ID)
+  { out("<").u(integer(rec, 4))(" records dropped>\n");
+    return; }
+
+  const char* codes = find(id);
+
+  if (!codes)
+  { errcode = ERR_INVALID_DATA;
+    return; }
+
+  const char* format = codes + strlen(codes) + 1;
+  uint32_t arg = 0;
+
+  for (uint32_t i = 0; ; i++)
+  { print_spec spec = print_format_parse(format, i);
+    literal(out, format + spec.from, spec.to - spec.from);
+
+    if (!spec.type) { break; }
+
+    if (spec.type == '%')
+    { out("%");
+      continue; }
+
+    char code = codes[arg++];
+    uint32_t n = code_size(code);
+    uint64_t raw = 0;
+    char text[256];
+
+    if (!code || rec >= end || rec + ((n) ? n : 1 + *rec) > end)
+    { errcode = ERR_INVALID_DATA;
+      return; }
+
+    if (n)
+    { raw = integer(rec, n);
+      rec += n;
+
+      // signed values are extended to 64 bits
+      if (n < 8 && strchr("bhi", code) && (raw >> (8 * n - 1)))
+      { raw |= ~0ULL << (8 * n); } }
+    else
+    { memcpy(text, rec + 1, *rec);
+      text[*rec] = '\0';
+      rec += 1 + *rec; }
+
+    // same conversion as print::fmt() makes, widths are minimums
+    if (!n) { out.value(spec, (const char*)text); }
+    else if (code == 'f')
+    { float val;
+      uint32_t bits = (uint32_t)raw;
+      memcpy(&val, &bits, sizeof(val));
+      out.value(spec, val); }
+    else if (code == 'd')
+    { double val;
+      memcpy(&val, &raw, sizeof(val));
+      out.value(spec, val); }
+    else { out.value(spec, raw); } }
+
+  if (!*format || format[strlen(format) - 1] != '\n') { out("\n"); } }
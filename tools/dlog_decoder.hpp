@@ -0,0 +1,85 @@
+/** \file dlog_decoder.hpp
+ *  \brief host side decoder of the deferred binary log */
+
+#ifndef DLOG_DECODER_HPP
+#define DLOG_DECODER_HPP
+
+#include <cstdint>
+#include "io/print.hpp"
+
+/** \brief maximum number of the entries of the string table */
+#ifndef DLOG_DECODER_ENTRIES
+  #define DLOG_DECODER_ENTRIES 4096
+#endif
+
+/** \brief   decoder of the records of the deferred log
+ *  \details string table is collected from the firmware image: ELF file or
+ *           raw binary, the entries are found by the marker. every record is
+ *           printed as separate line with the same conversions as
+ *           print::fmt() does */
+class dlog_decoder
+{ public:
+    /** \brief constructor
+     *
+     *  \param image      firmware image
+     *  \param size       size of the image
+     *  \param big_endian the records are written by big endian device */
+    dlog_decoder(const char* image, uint32_t size, bool big_endian = false);
+
+    /** \brief   decode the records
+     *  \details incomplete record at the end is left for the next call
+     *
+     *  \param data records
+     *  \param size size of the records
+     *  \param out  output of the text
+     *
+     *  \return number of the decoded bytes */
+    uint32_t decode(const uint8_t* data, uint32_t size, print& out);
+
+    /** \brief   last error code
+     *  \details ERR_INVALID_DATA for the broken stream or unknown id,
+     *           ERR_BUFFER_OVERFLOW if the table is too large */
+    uint8_t errcode;
+
+    /** \brief number of the entries of the string table */
+    uint32_t count;
+
+  private:
+    /** \brief entry of the string table */
+    class entry
+    { public:
+        /** \brief id of the records */
+        uint32_t id;
+
+        /** \brief type codes, zero and the format */
+        const char* text; };
+
+    /** \brief entries sorted by id */
+    entry entries[DLOG_DECODER_ENTRIES];
+
+    /** \brief byte order of the device */
+    bool big_endian;
+
+    /** \brief find the entry by id
+     *
+     *  \param id id of the record
+     *
+     *  \return text of the entry, nullptr if it's unknown */
+    const char* find(uint32_t id) const;
+
+    /** \brief decode one record
+     *
+     *  \param rec record
+     *  \param len size of the record
+     *  \param out output of the text */
+    void record(const uint8_t* rec, uint32_t len, print& out);
+
+    /** \brief read the integer of the record
+     *
+     *  \param p pointer to the bytes
+     *  \param n size of the integer
+     *
+     *  \return value */
+    uint64_t integer(const uint8_t* p, uint32_t n) const; };
+
+#endif // DLOG_DECODER_HPP
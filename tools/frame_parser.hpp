@@ -0,0 +1,440 @@
+/** \file    frame_parser.hpp
+ *  \brief   generator of the parsers of binary protocols
+ *  \details the frame is described by the list of its elements: preamble,
+ *           header fields, length field, payload, checksum and terminator.
+ *           the compiler makes the state machine from the list, it takes
+ *           one byte at a time, checks it at once and never returns to the
+ *           bytes that were already taken. complete frame is given to the
+ *           deserializer
+ *
+ *  \code
+ *  typedef frame_parser<64,
+ *                       frame_bytes<0xAA, 0x55>,
+ *                       frame_field<1>,
+ *                       frame_length<uint8_t>,
+ *                       frame_payload,
+ *                       frame_crc<crc16_modbus, false>,
+ *                       frame_bytes<0x0D>> my_parser;
+ *  my_parser parser;
+ *
+ *  if (parser.put(byte)) { deserializer in = parser.payload(); ... }
+ *  \endcode */
+
+#ifndef FRAME_PARSER_HPP
+#define FRAME_PARSER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include "tools/serializer.hpp"
+
+/** \defgroup frame_parser_results
+ *  \brief    results of the byte processing by the element
+ *  \{ */
+
+/** \brief element needs more bytes */
+#define FRAME_MORE 0
+
+/** \brief element is complete */
+#define FRAME_DONE 1
+
+/** \brief byte doesn't fit the element, frame is dropped */
+#define FRAME_FAIL 2
+/** \} */
+
+/** \brief   checksum of the frames without checksum
+ *  \details does nothing, it's used when there is no frame_crc element */
+class frame_no_sum
+{ public:
+    frame_no_sum& reset() { return *this; }
+
+    frame_no_sum& put(uint8_t byte) { (void)byte; return *this; }
+
+    uint8_t get() const { return 0; } };
+
+/** \brief   read the number from the frame
+ *
+ *  \tparam TYPE type of the number
+ *  \tparam BIG  number is big endian
+ *  \param  src  place of the number
+ *
+ *  \return value of the number */
+template <typename TYPE, bool BIG>
+inline TYPE frame_number(const uint8_t* src)
+{ TYPE val;
+  memcpy(&val, src, sizeof(TYPE));
+
+  if (BIG != HOST_BIG_ENDIAN) { byte_swap<sizeof(TYPE)>(&val); }
+
+  return val; }
+
+/** \brief   fixed bytes, preamble or terminator
+ *  \details every byte must match, the bytes aren't covered by the checksum
+ *
+ *  \tparam BYTES values of the bytes */
+template <uint8_t... BYTES>
+class frame_bytes
+{ public:
+    static_assert(sizeof...(BYTES) > 0, "no bytes");
+
+    typedef void sum;
+
+    static constexpr bool covered = false;
+
+    /** \brief start of the element
+     *
+     *  \param p parser
+     *
+     *  \return element has bytes */
+    template <typename PARSER>
+    static bool begin(PARSER& p)
+    { (void)p;
+      return true; }
+
+    /** \brief   next byte of the element
+     *  \details the byte is already stored in the frame and counted
+     *
+     *  \param p    parser
+     *  \param byte the byte
+     *
+     *  \return FRAME_MORE, FRAME_DONE or FRAME_FAIL */
+    template <typename PARSER>
+    static uint8_t put(PARSER& p, uint8_t byte)
+    { constexpr uint8_t bytes[] = { BYTES... };
+
+      if (byte != bytes[p.count - 1]) { return FRAME_FAIL; }
+
+      return (p.count == sizeof...(BYTES)) ? FRAME_DONE : FRAME_MORE; } };
+
+/** \brief header field of any value
+ *
+ *  \tparam SIZE size of the field */
+template <uint32_t SIZE>
+class frame_field
+{ public:
+    static_assert(SIZE > 0, "empty field");
+
+    typedef void sum;
+
+    static constexpr bool covered = true;
+
+    template <typename PARSER>
+    static bool begin(PARSER& p)
+    { (void)p;
+      return true; }
+
+    template <typename PARSER>
+    static uint8_t put(PARSER& p, uint8_t byte)
+    { (void)byte;
+      return (p.count == SIZE) ? FRAME_DONE : FRAME_MORE; } };
+
+/** \brief   length of the payload
+ *  \details the frame is dropped if the payload doesn't fit the parser
+ *
+ *  \tparam TYPE   type of the field
+ *  \tparam BIG    field is big endian
+ *  \tparam ADJUST value added to the field to get size of the payload, use
+ *                 it if the field counts more than the payload */
+template <typename TYPE, bool BIG = true, int32_t ADJUST = 0>
+class frame_length
+{ public:
+    typedef void sum;
+
+    static constexpr bool covered = true;
+
+    template <typename PARSER>
+    static bool begin(PARSER& p)
+    { (void)p;
+      return true; }
+
+    template <typename PARSER>
+    static uint8_t put(PARSER& p, uint8_t byte)
+    { (void)byte;
+
+      if (p.count < sizeof(TYPE)) { return FRAME_MORE; }
+
+      int64_t len = (int64_t)frame_number<TYPE, BIG>(p.data + p.used
+                                                       - sizeof(TYPE));
+      len += ADJUST;
+
+      if (len < 0 || len > (int64_t)(PARSER::capacity - p.used))
+      { return FRAME_FAIL; }
+
+      p.length = (uint32_t)len;
+      return FRAME_DONE; } };
+
+/** \brief payload of the size that is given by frame_length */
+class frame_payload
+{ public:
+    typedef void sum;
+
+    static constexpr bool covered = true;
+
+    template <typename PARSER>
+    static bool begin(PARSER& p)
+    { p.start = p.used;
+      return p.length > 0; }
+
+    template <typename PARSER>
+    static uint8_t put(PARSER& p, uint8_t byte)
+    { (void)byte;
+      return (p.count == p.length) ? FRAME_DONE : FRAME_MORE; } };
+
+/** \brief   payload that ends with the terminator
+ *  \details the terminator isn't a part of the payload, but it's covered by
+ *           the checksum if there is the checksum after it
+ *
+ *  \tparam BYTES values of the terminator */
+template <uint8_t... BYTES>
+class frame_until
+{ public:
+    static_assert(sizeof...(BYTES) > 0, "no terminator");
+
+    typedef void sum;
+
+    static constexpr bool covered = true;
+
+    template <typename PARSER>
+    static bool begin(PARSER& p)
+    { p.start = p.used;
+      return true; }
+
+    template <typename PARSER>
+    static uint8_t put(PARSER& p, uint8_t byte)
+    { constexpr uint8_t bytes[] = { BYTES... };
+      constexpr uint32_t len = sizeof...(BYTES);
+
+      if (byte != bytes[len - 1] || p.count < len) { return FRAME_MORE; }
+
+      if (memcmp(p.data + p.used - len, bytes, len)) { return FRAME_MORE; }
+
+      p.length = p.count - len;
+      return FRAME_DONE; } };
+
+/** \brief   checksum of the frame
+ *  \details covers all of the elements before it except fixed bytes, it's
+ *           calculated while the bytes arrive. mismatches are counted by the
+ *           parser
+ *
+ *  \tparam CRC crc calculator, see crc.hpp
+ *  \tparam BIG checksum is big endian */
+template <typename CRC, bool BIG = true>
+class frame_crc
+{ public:
+    typedef CRC sum;
+
+    typedef decltype(CRC().get()) type;
+
+    static constexpr bool covered = false;
+
+    template <typename PARSER>
+    static bool begin(PARSER& p)
+    { (void)p;
+      return true; }
+
+    template <typename PARSER>
+    static uint8_t put(PARSER& p, uint8_t byte)
+    { (void)byte;
+
+      if (p.count < sizeof(type)) { return FRAME_MORE; }
+
+      if (frame_number<type, BIG>(p.data + p.used - sizeof(type))
+          != p.sum.get())
+      { p.errors++;
+        return FRAME_FAIL; }
+
+      return FRAME_DONE; } };
+
+/** \brief checksum calculator of the first frame_crc of the list */
+template <typename... ELEMENTS>
+class frame_sum
+{ public:
+    typedef frame_no_sum type; };
+
+template <typename ELEMENT, typename... ELEMENTS>
+class frame_sum<ELEMENT, ELEMENTS...>
+{ public:
+    typedef typename frame_sum<ELEMENTS...>::type rest;
+
+    template <typename SUM, typename REST>
+    class pick
+    { public:
+        typedef SUM type; };
+
+    template <typename REST>
+    class pick<void, REST>
+    { public:
+        typedef REST type; };
+
+    typedef typename pick<typename ELEMENT::sum, rest>::type type; };
+
+/** \brief   dispatcher of the byte to the current element
+ *  \details unrolled by the compiler to the chain of comparisons
+ *
+ *  \tparam INDEX    index of the first element of the list
+ *  \tparam ELEMENTS rest of the elements */
+template <uint32_t INDEX, typename... ELEMENTS>
+class frame_chain
+{ public:
+    template <typename PARSER>
+    static bool begin(PARSER& p)
+    { (void)p;
+      return true; }
+
+    template <typename PARSER>
+    static uint8_t put(PARSER& p, uint8_t byte)
+    { (void)p;
+      (void)byte;
+      return FRAME_FAIL; } };
+
+template <uint32_t INDEX, typename ELEMENT, typename... ELEMENTS>
+class frame_chain<INDEX, ELEMENT, ELEMENTS...>
+{ public:
+    typedef frame_chain<INDEX + 1, ELEMENTS...> rest;
+
+    template <typename PARSER>
+    static bool begin(PARSER& p)
+    { return (p.state == INDEX) ? ELEMENT::begin(p) : rest::begin(p); }
+
+    template <typename PARSER>
+    static uint8_t put(PARSER& p, uint8_t byte)
+    { if (p.state != INDEX) { return rest::put(p, byte); }
+
+      if (ELEMENT::covered) { p.sum.put(byte); }
+
+      return ELEMENT::put(p, byte); } };
+
+/** \brief   incremental parser of the frames
+ *  \details if the byte doesn't fit the frame the candidate is dropped and
+ *           the byte is tried as the first byte of the next frame. bytes of
+ *           the dropped candidate aren't scanned again, so the frame that
+ *           starts inside of the broken one is lost
+ *
+ *  \tparam CAPACITY maximum size of the whole frame
+ *  \tparam ELEMENTS elements of the frame in the order of reception */
+template <uint32_t CAPACITY, typename... ELEMENTS>
+class frame_parser
+{ public:
+    static_assert(sizeof...(ELEMENTS) > 0, "empty frame");
+
+    /** \brief maximum size of the frame */
+    static constexpr uint32_t capacity = CAPACITY;
+
+    /** \brief number of the elements */
+    static constexpr uint32_t elements = sizeof...(ELEMENTS);
+
+    frame_parser() : errors(0), timeout(0), last(0) { reset(); }
+
+    /** \brief put received byte to the parser
+     *
+     *  \param byte received byte
+     *
+     *  \return result of parsing
+     *  \retval true  the frame is complete, it's valid until the next byte
+     *  \retval false frame is not complete yet */
+    bool put(uint8_t byte)
+    { if (ready || used == CAPACITY) { reset(); }
+
+      data[used++] = byte;
+      count++;
+      uint8_t res = chain::put(*this, byte);
+
+      if (res == FRAME_FAIL)
+      { bool first = (used == 1);
+        reset();
+
+        // the byte may be the start of the next frame
+        return (first) ? false : put(byte); }
+
+      if (res == FRAME_DONE)
+      { count = 0;
+        state++;
+        ready = enter(); }
+
+      return ready; }
+
+    /** \brief   put received byte to the parser with its time
+     *  \details incomplete frame is dropped if the gap before the byte is
+     *           longer than timeout
+     *
+     *  \param byte received byte
+     *  \param now  current time in ticks
+     *
+     *  \return see put() */
+    bool put(uint8_t byte, uint32_t now)
+    { if (timeout && used && !ready && now - last > timeout) { reset(); }
+
+      last = now;
+      return put(byte); }
+
+    /** \brief drop all of the received data */
+    void reset()
+    { used = 0;
+      count = 0;
+      state = 0;
+      start = 0;
+      length = 0;
+      ready = false;
+      sum.reset();
+      enter(); }
+
+    /** \brief payload of the complete frame
+     *
+     *  \return deserializer over the payload */
+    deserializer payload()
+    { return deserializer(data + start, (ready) ? length : 0); }
+
+    /** \brief whole complete frame
+     *
+     *  \return deserializer over the frame */
+    deserializer frame()
+    { return deserializer(data, (ready) ? used : 0); }
+
+    /** \brief received bytes of the frame */
+    uint8_t data[CAPACITY];
+
+    /** \brief number of the received bytes */
+    uint32_t used;
+
+    /** \brief number of the received bytes of the current element */
+    uint32_t count;
+
+    /** \brief index of the current element */
+    uint32_t state;
+
+    /** \brief offset of the payload */
+    uint32_t start;
+
+    /** \brief size of the payload */
+    uint32_t length;
+
+    /** \brief number of the frames with wrong checksum */
+    uint32_t errors;
+
+    /** \brief maximum gap between the bytes of the frame, 0 for no limit */
+    uint32_t timeout;
+
+    /** \brief running checksum of the frame */
+    typename frame_sum<ELEMENTS...>::type sum;
+
+  private:
+    typedef frame_chain<0, ELEMENTS...> chain;
+
+    /** \brief   start current element
+     *  \details empty elements are skipped
+     *
+     *  \return the frame is complete */
+    bool enter()
+    { while (state < elements)
+      { if (chain::begin(*this)) { return false; }
+
+        state++; }
+
+      return true; }
+
+    /** \brief frame is complete */
+    bool ready;
+
+    /** \brief time of the last byte */
+    uint32_t last; };
+
+#endif // FRAME_PARSER_HPP
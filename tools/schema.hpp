@@ -0,0 +1,271 @@
+/** \file    schema.hpp
+ *  \brief   declarative layout of the binary messages
+ *  \details fields of the message are listed once and the same list makes
+ *           both serializer and deserializer. size of the message and offset
+ *           of every field are known at compile time, so the message is
+ *           checked against the buffer once and the fields are copied to
+ *           fixed places without any checks
+ *
+ *  \code
+ *  class header
+ *  { public:
+ *      uint16_t addr;
+ *      uint32_t count;
+ *      char name[8]; };
+ *
+ *  typedef schema<be_field<&header::addr>,
+ *                 le_field<&header::count>,
+ *                 string_field<&header::name>> header_schema;
+ *
+ *  header_schema::pack(msg, out);
+ *  header_schema::unpack(msg, in);
+ *  \endcode */
+
+#ifndef SCHEMA_HPP
+#define SCHEMA_HPP
+
+#include <cstdint>
+#include <cstring>
+#include "tools/serializer.hpp"
+
+/** \brief type of the class member
+ *
+ *  \tparam MEMBER pointer to the member */
+template <typename MEMBER>
+class schema_member;
+
+template <typename OBJECT, typename TYPE>
+class schema_member<TYPE OBJECT::*>
+{ public:
+    typedef TYPE type; };
+
+template <typename OBJECT, typename TYPE, uint32_t LEN>
+class schema_member<TYPE (OBJECT::*)[LEN]>
+{ public:
+    typedef TYPE type;
+
+    /** \brief number of the elements of the array member */
+    static constexpr uint32_t length = LEN; };
+
+/** \brief scalar field
+ *
+ *  \tparam MEMBER pointer to the member
+ *  \tparam SWAP   reverse byte order of the value */
+template <auto MEMBER, bool SWAP>
+class schema_value
+{ public:
+    typedef typename schema_member<decltype(MEMBER)>::type type;
+
+    /** \brief size of the field in the message */
+    static constexpr uint32_t size = sizeof(type);
+
+    /** \brief write the field without checks
+     *
+     *  \param obj source object
+     *  \param dst place of the field in the message */
+    template <typename OBJECT>
+    static void write(const OBJECT& obj, uint8_t* dst)
+    { memcpy(dst, &(obj.*MEMBER), size);
+
+      if (SWAP) { byte_swap<size>(dst); } }
+
+    /** \brief read the field without checks
+     *
+     *  \param obj destination object
+     *  \param src place of the field in the message */
+    template <typename OBJECT>
+    static void read(OBJECT& obj, const uint8_t* src)
+    { memcpy(&(obj.*MEMBER), src, size);
+
+      if (SWAP) { byte_swap<size>(&(obj.*MEMBER)); } } };
+
+/** \brief array field, every element has the same byte order
+ *
+ *  \tparam MEMBER pointer to the array member
+ *  \tparam SWAP   reverse byte order of every element */
+template <auto MEMBER, bool SWAP>
+class schema_array
+{ public:
+    typedef schema_member<decltype(MEMBER)> member;
+    typedef typename member::type type;
+
+    /** \brief size of the field in the message */
+    static constexpr uint32_t size = sizeof(type) * member::length;
+
+    template <typename OBJECT>
+    static void write(const OBJECT& obj, uint8_t* dst)
+    { memcpy(dst, obj.*MEMBER, size);
+
+      if (SWAP)
+      { for (uint32_t i = 0; i < member::length; i++)
+        { byte_swap<sizeof(type)>(dst + i * sizeof(type)); } } }
+
+    template <typename OBJECT>
+    static void read(OBJECT& obj, const uint8_t* src)
+    { memcpy(obj.*MEMBER, src, size);
+
+      if (SWAP)
+      { for (uint32_t i = 0; i < member::length; i++)
+        { byte_swap<sizeof(type)>(&(obj.*MEMBER)[i]); } } } };
+
+/** \brief   fixed size string field
+ *  \details the field takes the whole array in the message, the rest of the
+ *           string is filled by zeros. last byte is always zero, so the
+ *           string that is read is always terminated
+ *
+ *  \tparam MEMBER pointer to the char array member */
+template <auto MEMBER>
+class string_field
+{ public:
+    typedef schema_member<decltype(MEMBER)> member;
+
+    /** \brief size of the field in the message */
+    static constexpr uint32_t size = member::length;
+
+    template <typename OBJECT>
+    static void write(const OBJECT& obj, uint8_t* dst)
+    { const char* str = obj.*MEMBER;
+      uint32_t len = 0;
+
+      while (len < size - 1 && str[len]) { len++; }
+
+      memcpy(dst, str, len);
+      memset(dst + len, 0, size - len); }
+
+    template <typename OBJECT>
+    static void read(OBJECT& obj, const uint8_t* src)
+    { memcpy(obj.*MEMBER, src, size - 1);
+      (obj.*MEMBER)[size - 1] = '\0'; } };
+
+/** \brief big endian field */
+template <auto MEMBER>
+using be_field = schema_value<MEMBER, !HOST_BIG_ENDIAN>;
+
+/** \brief little endian field */
+template <auto MEMBER>
+using le_field = schema_value<MEMBER, HOST_BIG_ENDIAN>;
+
+/** \brief field in byte order of the host, use it for single bytes */
+template <auto MEMBER>
+using raw_field = schema_value<MEMBER, false>;
+
+/** \brief array of big endian elements */
+template <auto MEMBER>
+using be_array = schema_array<MEMBER, !HOST_BIG_ENDIAN>;
+
+/** \brief array of little endian elements */
+template <auto MEMBER>
+using le_array = schema_array<MEMBER, HOST_BIG_ENDIAN>;
+
+/** \brief   fields of the message placed one after another
+ *  \details offset of every field is the template argument, so the compiler
+ *           sees the constant address of every access
+ *
+ *  \tparam OFFSET offset of the first field of the list
+ *  \tparam FIELDS rest of the fields */
+template <uint32_t OFFSET, typename... FIELDS>
+class schema_layout
+{ public:
+    template <typename OBJECT>
+    static void write(const OBJECT& obj, uint8_t* dst)
+    { (void)obj;
+      (void)dst; }
+
+    template <typename OBJECT>
+    static void read(OBJECT& obj, const uint8_t* src)
+    { (void)obj;
+      (void)src; } };
+
+template <uint32_t OFFSET, typename FIELD, typename... FIELDS>
+class schema_layout<OFFSET, FIELD, FIELDS...>
+{ public:
+    typedef schema_layout<OFFSET + FIELD::size, FIELDS...> rest;
+
+    template <typename OBJECT>
+    static void write(const OBJECT& obj, uint8_t* dst)
+    { FIELD::write(obj, dst + OFFSET);
+      rest::write(obj, dst); }
+
+    template <typename OBJECT>
+    static void read(OBJECT& obj, const uint8_t* src)
+    { FIELD::read(obj, src + OFFSET);
+      rest::read(obj, src); } };
+
+/** \brief   layout of the message
+ *  \details pack() and unpack() check the space in the stream once and then
+ *           copy all of the fields. write() and read() don't check anything,
+ *           use them when size of the buffer is known to be enough
+ *
+ *  \tparam FIELDS fields of the message in the order of transmission */
+template <typename... FIELDS>
+class schema
+{ public:
+    /** \brief size of the message */
+    static constexpr uint32_t size = (0 + ... + FIELDS::size);
+
+    /** \brief number of the fields */
+    static constexpr uint32_t fields = sizeof...(FIELDS);
+
+    /** \brief offset of the field in the message
+     *
+     *  \param index index of the field
+     *
+     *  \return offset of the field, size of the message for the index past
+     *          the last field */
+    static constexpr uint32_t offset(uint32_t index)
+    { constexpr uint32_t sizes[] = { FIELDS::size..., 0 };
+      uint32_t result = 0;
+
+      for (uint32_t i = 0; i < index && i < fields; i++) { result += sizes[i]; }
+
+      return result; }
+
+    /** \brief write the message without checks
+     *
+     *  \param obj source object
+     *  \param dst buffer of at least size bytes */
+    template <typename OBJECT>
+    static void write(const OBJECT& obj, uint8_t* dst)
+    { schema_layout<0, FIELDS...>::write(obj, dst); }
+
+    /** \brief read the message without checks
+     *
+     *  \param obj destination object
+     *  \param src buffer of at least size bytes */
+    template <typename OBJECT>
+    static void read(OBJECT& obj, const uint8_t* src)
+    { schema_layout<0, FIELDS...>::read(obj, src); }
+
+    /** \brief   insert the message in the data stream
+     *  \details nothing is written if there is not enough space, errcode of
+     *           the stream is set then
+     *
+     *  \param obj source object
+     *  \param out stream
+     *
+     *  \return reference to the stream */
+    template <typename OBJECT>
+    static serializer& pack(const OBJECT& obj, serializer& out)
+    { uint8_t* dst = out.chunk(size);
+
+      if (dst) { write(obj, dst); }
+
+      return out; }
+
+    /** \brief   extract the message from the data stream
+     *  \details the object is untouched if the stream is too short, errcode
+     *           of the stream is set then
+     *
+     *  \param obj destination object
+     *  \param in  stream
+     *
+     *  \return reference to the stream */
+    template <typename OBJECT>
+    static deserializer& unpack(OBJECT& obj, deserializer& in)
+    { const uint8_t* src = in.chunk(size);
+
+      if (src) { read(obj, src); }
+
+      return in; } };
+
+#endif // SCHEMA_HPP
@@ -7,27 +7,153 @@
 #include "tools/serializer.hpp"
 #include "core/errcode.hpp"
 
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#elif defined(__SSSE3__)
+  #include <tmmintrin.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+#endif
+
 /** \brief memcpy with adjustable byte order
  *
  *  \param dst pointer to the destination buffer of data
  *  \param src pointer to the data source
  *  \param len length of the data to copy
  *  \param rev flag to reverse a byte order */
-static void copy(void* dst, void* src, uint32_t len, bool rev = false)
-{ uint8_t* s = (uint8_t*)src;
+static void copy(void* dst, const void* src, uint32_t len, bool rev = false)
+{ if (!rev) { memcpy(dst, src, len); return; }
+
+  const uint8_t* s = (const uint8_t*)src + len;
   uint8_t* d = (uint8_t*)dst;
-  uint32_t s_count = 0;
-  uint32_t d_count = (rev) ? len - 1 : 0;
-  int step = (rev) ? -1 : 1;
 
-  while (len) { d[d_count] = s[s_count]; s_count++; d_count += step; len--; } }
+  while (len) { s--; *d = *s; d++; len--; } }
+
+/** \brief   shuffle pattern that reverses every element of 16 bytes
+ *
+ *  \tparam SIZE size of the element */
+template <uint32_t SIZE>
+class swap_pattern
+{ public:
+    constexpr swap_pattern() : idx()
+    { for (uint32_t i = 0; i < 16; i++)
+      { idx[i] = (uint8_t)(i / SIZE * SIZE + SIZE - 1 - i % SIZE); } }
+
+    /** \brief index of the source byte for every destination byte */
+    uint8_t idx[16]; };
+
+/** \brief   reverse every element of 16 bytes
+ *
+ *  \tparam SIZE size of the element, 2, 4 or 8
+ *  \param  dst  pointer to the destination
+ *  \param  src  pointer to the source
+ *
+ *  \return 16 if the block is done, 0 if there is no SIMD for it */
+template <uint32_t SIZE>
+static inline uint32_t swap_block(uint8_t* dst, const uint8_t* src)
+{
+#if defined(__SSSE3__)
+  static constexpr swap_pattern<SIZE> pattern = {};
+  __m128i mask = _mm_loadu_si128((const __m128i*)pattern.idx);
+  __m128i v = _mm_loadu_si128((const __m128i*)src);
+  _mm_storeu_si128((__m128i*)dst, _mm_shuffle_epi8(v, mask));
+  return 16;
+#elif defined(__SSE2__)
+  __m128i v = _mm_loadu_si128((const __m128i*)src);
+
+  // reorder 16 bit words inside of the element, then swap bytes of the words
+  if (SIZE == 4)
+  { v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1); }
+
+  if (SIZE == 8)
+  { v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1B), 0x1B); }
+
+  v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+  _mm_storeu_si128((__m128i*)dst, v);
+  return 16;
+#elif defined(__ARM_NEON)
+  uint8x16_t v = vld1q_u8(src);
+
+  if (SIZE == 2) { v = vrev16q_u8(v); }
+
+  if (SIZE == 4) { v = vrev32q_u8(v); }
+
+  if (SIZE == 8) { v = vrev64q_u8(v); }
+
+  vst1q_u8(dst, v);
+  return 16;
+#else
+  (void)dst;
+  (void)src;
+  return 0;
+#endif
+}
+
+/** \brief   copy the array and reverse every element
+ *
+ *  \tparam SIZE  size of the element
+ *  \param  dst   pointer to the destination
+ *  \param  src   pointer to the source
+ *  \param  count number of the elements */
+template <uint32_t SIZE>
+static void swap_array(uint8_t* dst, const uint8_t* src, uint32_t count)
+{ uint32_t len = SIZE * count;
+  uint32_t i = 0;
+
+#if defined(__AVX2__)
+  static constexpr swap_pattern<SIZE> pattern = {};
+  __m256i mask = _mm256_broadcastsi128_si256(
+                   _mm_loadu_si128((const __m128i*)pattern.idx));
+
+  // elements never cross 16 byte lanes, so in-lane shuffle is enough
+  for (; i + 32 <= len; i += 32)
+  { __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+    _mm256_storeu_si256((__m256i*)(dst + i), _mm256_shuffle_epi8(v, mask)); }
+#endif
+
+  while (i + 16 <= len)
+  { uint32_t done = swap_block<SIZE>(dst + i, src + i);
+
+    if (!done) { break; }
+
+    i += done; }
+
+  for (; i < len; i += SIZE)
+  { uint8_t val[SIZE];
+    memcpy(val, src + i, SIZE);
+    byte_swap<SIZE>(val);
+    memcpy(dst + i, val, SIZE); } }
+
+void byte_swap_copy(void* dst, const void* src, uint32_t size, uint32_t count)
+{ uint8_t* d = (uint8_t*)dst;
+  const uint8_t* s = (const uint8_t*)src;
+
+  switch (size)
+  { case 1: memmove(d, s, count); break;
+
+    case 2: swap_array<2>(d, s, count); break;
+
+    case 4: swap_array<4>(d, s, count); break;
+
+    case 8: swap_array<8>(d, s, count); break;
+
+    default:
+      for (uint32_t i = 0; i < count; i++, d += size, s += size)
+      { for (uint32_t j = 0; j < (size + 1) / 2; j++)
+        { uint8_t t = s[j];
+          d[j] = s[size - 1 - j];
+          d[size - 1 - j] = t; } } } }
 
 serializer::serializer(void* buffer, uint32_t buffer_size)
   : pos(0),
     errcode(ERR_OK),
     byte_order(false),
     buffer(buffer),
-    buffer_size(buffer_size)
+    buffer_size(buffer_size),
+    bit(0),
+    bits_at(0)
 {}
 
 serializer& serializer::hn()
@@ -46,7 +172,13 @@ serializer& serializer::a(void* buf, uint32_t len)
 
 serializer& serializer::s(const char* str, uint32_t len)
 { uint32_t counter = (len == NO_LIMITS) ? 0xFFFFFFFF : len;
-  char* buf = (char*)buffer;
+
+  if (pos >= buffer_size)
+  { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERFLOW; }
+
+    return *this; }
+
+  char* buf = (char*)buffer + pos;
 
   while (*str && counter && pos + 1 < buffer_size)
   { *buf = *str;
@@ -59,7 +191,63 @@ serializer& serializer::s(const char* str, uint32_t len)
   return *this; }
 
 serializer& serializer::s(char* str, uint32_t len)
-{ return s((char*)str, len); }
+{ return s((const char*)str, len); }
+
+serializer& serializer::var(uint64_t val)
+{ uint32_t len = varint_size(val);
+
+  if (pos + len > buffer_size)
+  { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERFLOW; }
+
+    return *this; }
+
+  uint8_t* dst = (uint8_t*)buffer + pos;
+
+  for (uint32_t i = 0; i < len - 1; i++)
+  { dst[i] = (uint8_t)(val | 0x80);
+    val >>= 7; }
+
+  dst[len - 1] = (uint8_t)val;
+  pos += len;
+  return *this; }
+
+serializer& serializer::b(uint32_t val, uint8_t bits)
+{ if (!bits || bits > 32)
+  { if (errcode == ERR_OK) { errcode = ERR_INVALID_ARGUMENT; }
+
+    return *this; }
+
+  // continue the last byte if nothing was written after it
+  uint8_t used = (bits_at == pos) ? bit : 0;
+  uint32_t total = (used + bits + 7) / 8;
+  uint32_t added = (used) ? total - 1 : total;
+
+  if (pos + added > buffer_size)
+  { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERFLOW; }
+
+    return *this; }
+
+  uint8_t* dst = (uint8_t*)buffer + pos + added - total;
+  uint64_t acc = (uint64_t)(val & (uint32_t)((1ULL << bits) - 1)) << used;
+
+  if (used) { acc |= dst[0]; }
+
+  for (uint32_t i = 0; i < total; i++) { dst[i] = (uint8_t)(acc >> (8 * i)); }
+
+  pos += added;
+  bit = (uint8_t)((used + bits) & 7);
+  bits_at = pos;
+  return *this; }
+
+uint8_t* serializer::chunk(uint32_t len)
+{ if (pos + len > buffer_size)
+  { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERFLOW; }
+
+    return nullptr; }
+
+  uint8_t* space = (uint8_t*)buffer + pos;
+  pos += len;
+  return space; }
 
 serializer& serializer::seek(int32_t step)
 { if (step > 0)
@@ -73,7 +261,9 @@ deserializer::deserializer(void* buffer, uint32_t buffer_size)
     errcode(ERR_OK),
     byte_order(false),
     buffer(buffer),
-    buffer_size(buffer_size)
+    buffer_size(buffer_size),
+    bit(0),
+    bits_at(0)
 {}
 
 deserializer& deserializer::hn()
@@ -91,23 +281,98 @@ deserializer& deserializer::a(void* buf, uint32_t len)
   return *this; }
 
 deserializer& deserializer::s(char* buf, uint32_t len)
-{ char* str = (char*)buffer;
-  uint32_t counter = (len == NO_LIMITS) ? 0xFFFFFFFF : len;
+{ uint32_t counter = (len == NO_LIMITS) ? 0xFFFFFFFF : len;
+
+  if (counter) { *buf = 0; }
+
+  if (pos >= buffer_size)
+  { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERRUN; }
+
+    return *this; }
 
-  while (*str && counter - 1 && pos < buffer_size)
+  const char* str = (const char*)buffer + pos;
+
+  // the sequence is read only after the bounds check
+  while (counter > 1 && pos < buffer_size && *str)
   { *buf = *str;
     str++; buf++; pos++; counter--; }
 
-  if (*str != 0) { errcode = ERR_BUFFER_OVERRUN; }
+  if (counter) { *buf = 0; }
 
-  *buf = 0;
+  bool cut = pos < buffer_size && *str;
 
-  while (*str && pos < buffer_size) { str++; pos++; }
+  while (pos < buffer_size && *str) { str++; pos++; }
 
+  // terminator is skipped if it's there
   if (pos < buffer_size) { pos++; }
+  else { cut = true; }
+
+  if (cut && errcode == ERR_OK) { errcode = ERR_BUFFER_OVERRUN; }
 
   return *this; }
 
+bool deserializer::varint(uint64_t& val)
+{ const uint8_t* src = (const uint8_t*)buffer + pos;
+  uint32_t left = (pos < buffer_size) ? buffer_size - pos : 0;
+  uint32_t limit = (left < 10) ? left : 10;
+  uint64_t res = 0;
+
+  for (uint32_t i = 0; i < limit; i++)
+  { res |= (uint64_t)(src[i] & 0x7F) << (7 * i);
+
+    if (src[i] & 0x80) { continue; }
+
+    // tenth byte can carry only the highest bit of 64
+    if (i == 9 && src[i] > 1) { break; }
+
+    pos += i + 1;
+    val = res;
+    return true; }
+
+  if (errcode == ERR_OK)
+  { errcode = (limit == 10) ? ERR_INVALID_DATA : ERR_BUFFER_OVERRUN; }
+
+  return false; }
+
+bool deserializer::field(uint32_t& val, uint8_t bits)
+{ if (!bits || bits > 32)
+  { if (errcode == ERR_OK) { errcode = ERR_INVALID_ARGUMENT; }
+
+    return false; }
+
+  uint8_t used = (bits_at == pos) ? bit : 0;
+  uint32_t total = (used + bits + 7) / 8;
+  uint32_t added = (used) ? total - 1 : total;
+
+  if (pos + added > buffer_size)
+  { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERRUN; }
+
+    return false; }
+
+  const uint8_t* src = (const uint8_t*)buffer + pos + added - total;
+  uint64_t acc = 0;
+
+  for (uint32_t i = 0; i < total; i++) { acc |= (uint64_t)src[i] << (8 * i); }
+
+  val = (uint32_t)((acc >> used) & ((1ULL << bits) - 1));
+  pos += added;
+  bit = (uint8_t)((used + bits) & 7);
+  bits_at = pos;
+  return true; }
+
+const uint8_t* deserializer::chunk(uint32_t len)
+{ if (pos + len > buffer_size)
+  { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERRUN; }
+
+    return nullptr; }
+
+  const uint8_t* piece = (const uint8_t*)buffer + pos;
+  pos += len;
+  return piece; }
+
+deserializer_view deserializer::view(uint32_t len)
+{ return deserializer_view(chunk(len), len, byte_order); }
+
 deserializer& deserializer::seek(int32_t step)
 { if (step > 0)
   { pos = (buffer_size - pos < (uint32_t)step) ? buffer_size : pos + step; }
@@ -10,10 +10,94 @@
 #define SERIALIZER_HPP
 
 #include <cstdint>
+#include <cstring>
+#include <limits>
 #include "containers/arrayed_buffer.hpp"
+#include "core/errcode.hpp"
 
 #define NO_LIMITS 0
 
+/** \brief   byte order of the target
+ *  \details defined by the compiler, little endian is assumed if the compiler
+ *           doesn't tell it */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  #define HOST_BIG_ENDIAN true
+#else
+  #define HOST_BIG_ENDIAN false
+#endif
+
+/** \brief   reverse byte order of the value in place
+ *  \details values of 2, 4 and 8 bytes are swapped by one instruction
+ *
+ *  \tparam SIZE size of the value
+ *  \param  val  pointer to the value */
+template <uint32_t SIZE>
+inline void byte_swap(void* val)
+{ uint8_t* p = (uint8_t*)val;
+
+  for (uint32_t i = 0; i < SIZE / 2; i++)
+  { uint8_t t = p[i];
+    p[i] = p[SIZE - 1 - i];
+    p[SIZE - 1 - i] = t; } }
+
+template <>
+inline void byte_swap<2>(void* val)
+{ uint16_t v;
+  memcpy(&v, val, sizeof(v));
+  v = __builtin_bswap16(v);
+  memcpy(val, &v, sizeof(v)); }
+
+template <>
+inline void byte_swap<4>(void* val)
+{ uint32_t v;
+  memcpy(&v, val, sizeof(v));
+  v = __builtin_bswap32(v);
+  memcpy(val, &v, sizeof(v)); }
+
+template <>
+inline void byte_swap<8>(void* val)
+{ uint64_t v;
+  memcpy(&v, val, sizeof(v));
+  v = __builtin_bswap64(v);
+  memcpy(val, &v, sizeof(v)); }
+
+/** \brief   copy the array and reverse byte order of every element
+ *  \details uses SIMD shuffles where they are available (AVX2, SSSE3, SSE2,
+ *           NEON), otherwise swaps element by element. source and
+ *           destination may be the same array
+ *
+ *  \param dst   pointer to the destination
+ *  \param src   pointer to the source
+ *  \param size  size of one element
+ *  \param count number of the elements */
+void byte_swap_copy(void* dst, const void* src, uint32_t size, uint32_t count);
+
+/** \brief   map the signed value to unsigned one with small magnitude
+ *  \details 0, -1, 1, -2, 2... become 0, 1, 2, 3, 4..., so the varint of the
+ *           small negative value is short too
+ *
+ *  \param val signed value
+ *
+ *  \return zigzag code */
+constexpr uint64_t zigzag_encode(int64_t val)
+{ return ((uint64_t)val << 1) ^ (uint64_t)(val >> 63); }
+
+/** \brief restore the signed value from the zigzag code
+ *
+ *  \param val zigzag code
+ *
+ *  \return signed value */
+constexpr int64_t zigzag_decode(uint64_t val)
+{ return (int64_t)((val >> 1) ^ (0 - (val & 1))); }
+
+/** \brief number of the bytes of the varint
+ *
+ *  \param val value
+ *
+ *  \return size of the varint, from 1 to 10 */
+inline uint32_t varint_size(uint64_t val)
+{ return (uint32_t)(63 - __builtin_clzll(val | 1)) / 7 + 1; }
+
 /** \brief a tool to make the generic serial data generator */
 class serializer
 { public:
@@ -39,7 +123,8 @@ class serializer
      *
      *  \return reference to the current serializer object */
     template <typename TYPE>
-    serializer& v(TYPE val) { return a(&val, sizeof(TYPE)); }
+    serializer& v(TYPE val)
+    { return (byte_order) ? put<true>(val) : put<false>(val); }
 
     /** \brief   insert the value by pointer in the data stream
      *  \warning be careful using the type that actually is an array.
@@ -52,7 +137,28 @@ class serializer
      *
      *  \return reference to the current serializer object */
     template <typename TYPE>
-    serializer& v(TYPE* val) { return a(val, sizeof(TYPE)); }
+    serializer& v(TYPE* val)
+    { return (byte_order) ? put<true>(*val) : put<false>(*val); }
+
+    /** \brief   insert the value in big endian order
+     *  \details byte order is known at compile time, hn() doesn't affect it
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  value
+     *
+     *  \return reference to the current serializer object */
+    template <typename TYPE>
+    serializer& be(TYPE val) { return put<!HOST_BIG_ENDIAN>(val); }
+
+    /** \brief   insert the value in little endian order
+     *  \details byte order is known at compile time, hn() doesn't affect it
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  value
+     *
+     *  \return reference to the current serializer object */
+    template <typename TYPE>
+    serializer& le(TYPE val) { return put<HOST_BIG_ENDIAN>(val); }
 
     /** \brief add array to the sequence
      *
@@ -62,6 +168,26 @@ class serializer
      *  \return reference to the current serializer object */
     serializer& a(void* buf, uint32_t len);
 
+    /** \brief   add typed array to the sequence
+     *  \details unlike a() the byte order of every element is changed
+     *           separately when hn() is active
+     *
+     *  \tparam TYPE  type of the elements
+     *  \param  val   pointer to the array
+     *  \param  count number of the elements
+     *
+     *  \return reference to the current serializer object */
+    template <typename TYPE>
+    serializer& av(const TYPE* val, uint32_t count)
+    { uint8_t* dst = chunk(sizeof(TYPE) * count);
+
+      if (!dst) { return *this; }
+
+      if (byte_order) { byte_swap_copy(dst, val, sizeof(TYPE), count); }
+      else { memcpy(dst, val, sizeof(TYPE) * count); }
+
+      return *this; }
+
     /** \brief   add c-string to the sequence
      *  \details this method guarantees that all available data would be
      *           written in buffer in borders of requested field size.
@@ -81,6 +207,43 @@ class serializer
      *  \return reference to the current serializer object */
     serializer& s(char* str, uint32_t len = NO_LIMITS);
 
+    /** \brief   add unsigned value as LEB128 varint
+     *  \details 7 bits per byte, lowest bits first, highest bit of the byte
+     *           is set if there are more bytes. size is known before the
+     *           writing, so the space is checked once
+     *
+     *  \param val value
+     *
+     *  \return reference to the current serializer object */
+    serializer& var(uint64_t val);
+
+    /** \brief add signed value as zigzag encoded varint
+     *
+     *  \param val value
+     *
+     *  \return reference to the current serializer object */
+    serializer& zz(int64_t val) { return var(zigzag_encode(val)); }
+
+    /** \brief   add bit field
+     *  \details consecutive bit fields are packed together from the lowest
+     *           bit of the byte, unused bits of the last byte are zero. any
+     *           other field starts from the next byte
+     *
+     *  \param val  value, only lowest bits are used
+     *  \param bits size of the field, from 1 to 32
+     *
+     *  \return reference to the current serializer object */
+    serializer& b(uint32_t val, uint8_t bits);
+
+    /** \brief   reserve the space in the sequence
+     *  \details the space is checked once and filled by the caller, use it
+     *           to write several fields without checks
+     *
+     *  \param len size of the space
+     *
+     *  \return pointer to the space or null if there is not enough space */
+    uint8_t* chunk(uint32_t len);
+
     /** \brief move through the sequence forwards or backwards
      *
      *  \param step number and direction of steps according the current point
@@ -95,8 +258,30 @@ class serializer
     uint8_t errcode;
 
   private:
+    /** \brief   store the value by one unaligned write
+     *
+     *  \tparam SWAP reverse byte order
+     *  \tparam TYPE type of the variable
+     *  \param  val  value
+     *
+     *  \return reference to the current serializer object */
+    template <bool SWAP, typename TYPE>
+    serializer& put(const TYPE& val)
+    { if (pos + sizeof(TYPE) > buffer_size)
+      { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERFLOW; }
+
+        return *this; }
+
+      uint8_t* dst = (uint8_t*)buffer + pos;
+      memcpy(dst, &val, sizeof(TYPE));
+
+      if (SWAP) { byte_swap<sizeof(TYPE)>(dst); }
+
+      pos += sizeof(TYPE);
+      return *this; }
+
     /** \brief current byte order
-     *  \note true for straign system order, false for reverse order */
+     *  \note false for straight system order, true for reverse order */
     bool byte_order;
 
     /** \brief pointer to the external buffer where the serial data would be
@@ -104,7 +289,15 @@ class serializer
     void* buffer;
 
     /** \brief size of the external buffer */
-    uint32_t buffer_size; };
+    uint32_t buffer_size;
+
+    /** \brief number of the used bits of the last bit field byte */
+    uint8_t bit;
+
+    /** \brief position after the last bit field byte */
+    uint32_t bits_at; };
+
+class deserializer_view;
 
 /** \brief tool to make generic serial data parser */
 class deserializer
@@ -131,7 +324,8 @@ class deserializer
      *
      *  \return reference to the current deserializer object */
     template <typename TYPE>
-    deserializer& v(TYPE& val) { return a(&val, sizeof(TYPE)); }
+    deserializer& v(TYPE& val)
+    { return (byte_order) ? get<true>(val) : get<false>(val); }
 
     /** \brief   extracts the value by pointer form the sequence
      *  \warning be careful using the type that actually is an array.
@@ -144,7 +338,27 @@ class deserializer
      *
      *  \return reference to the current deserializer object */
     template <typename TYPE>
-    deserializer& v(TYPE* val) { return a(val, sizeof(TYPE)); }
+    deserializer& v(TYPE* val) { return v<TYPE>(*val); }
+
+    /** \brief   extracts the value in big endian order
+     *  \details byte order is known at compile time, hn() doesn't affect it
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current deserializer object */
+    template <typename TYPE>
+    deserializer& be(TYPE& val) { return get<!HOST_BIG_ENDIAN>(val); }
+
+    /** \brief   extracts the value in little endian order
+     *  \details byte order is known at compile time, hn() doesn't affect it
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current deserializer object */
+    template <typename TYPE>
+    deserializer& le(TYPE& val) { return get<HOST_BIG_ENDIAN>(val); }
 
     /** \brief extracts array from the sequence
      *  \warning there is no any check for buffer size, I hope you can deal
@@ -156,18 +370,125 @@ class deserializer
      *  \return reference to the current deserializer object */
     deserializer& a(void* buf, uint32_t len);
 
+    /** \brief   extracts typed array from the sequence
+     *  \details unlike a() the byte order of every element is changed
+     *           separately when hn() is active
+     *
+     *  \tparam TYPE  type of the elements
+     *  \param  val   pointer to the array
+     *  \param  count number of the elements
+     *
+     *  \return reference to the current deserializer object */
+    template <typename TYPE>
+    deserializer& av(TYPE* val, uint32_t count)
+    { const uint8_t* src = chunk(sizeof(TYPE) * count);
+
+      if (!src) { return *this; }
+
+      if (byte_order) { byte_swap_copy(val, src, sizeof(TYPE), count); }
+      else { memcpy(val, src, sizeof(TYPE) * count); }
+
+      return *this; }
+
     /** \brief   extracts string from the sequence
      *  \details guarantees that current point would be straight after the
      *           string terminator
+     *  \details string that doesn't fit len or has no terminator before
+     *           the end of the sequence is cut and ERR_BUFFER_OVERRUN is set
      *  \warning there is no any chek for the buffer size until len parameter.
      *           I think you can deal with it.
      *
      *  \param buf pointer to the bufer for the string
-     *  \param len size of the string in the sequence
+     *  \param len size of the buffer for the string, with the terminator
      *
      *  \return reference to the curren deserializer object */
     deserializer& s(char* buf, uint32_t len = NO_LIMITS);
 
+    /** \brief   extracts unsigned LEB128 varint
+     *  \details ERR_INVALID_DATA is set if the varint is longer than 10 bytes
+     *           or the value doesn't fit the variable
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current deserializer object */
+    template <typename TYPE>
+    deserializer& var(TYPE& val)
+    { uint64_t raw = 0;
+      uint32_t start = pos;
+
+      if (!varint(raw)) { return *this; }
+
+      if (raw > (uint64_t)std::numeric_limits<TYPE>::max())
+      { if (errcode == ERR_OK) { errcode = ERR_INVALID_DATA; }
+
+        pos = start;
+        return *this; }
+
+      val = (TYPE)raw;
+      return *this; }
+
+    /** \brief extracts signed zigzag encoded varint
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current deserializer object */
+    template <typename TYPE>
+    deserializer& zz(TYPE& val)
+    { uint64_t raw = 0;
+      uint32_t start = pos;
+
+      if (!varint(raw)) { return *this; }
+
+      int64_t res = zigzag_decode(raw);
+
+      if (res < (int64_t)std::numeric_limits<TYPE>::min()
+          || res > (int64_t)std::numeric_limits<TYPE>::max())
+      { if (errcode == ERR_OK) { errcode = ERR_INVALID_DATA; }
+
+        pos = start;
+        return *this; }
+
+      val = (TYPE)res;
+      return *this; }
+
+    /** \brief   extracts bit field
+     *  \details see serializer::b()
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *  \param  bits size of the field, from 1 to 32
+     *
+     *  \return reference to the current deserializer object */
+    template <typename TYPE>
+    deserializer& b(TYPE& val, uint8_t bits)
+    { uint32_t raw = 0;
+
+      if (field(raw, bits)) { val = (TYPE)raw; }
+
+      return *this; }
+
+    /** \brief   take the piece of the sequence
+     *  \details the piece is checked once and read by the caller, use it to
+     *           read several fields without checks
+     *
+     *  \param len size of the piece
+     *
+     *  \return pointer to the piece or null if the sequence is shorter */
+    const uint8_t* chunk(uint32_t len);
+
+    /** \brief   take the record of the fixed size
+     *  \details the record is checked once, its fields are read from the
+     *           view without any checks. the view follows current byte order.
+     *           variable part after the record is read from the deserializer
+     *           as usual
+     *
+     *  \param len size of the record
+     *
+     *  \return view of the record, false if the sequence is shorter */
+    deserializer_view view(uint32_t len);
+
     /** \brief move through the sequence forwards of backwards
      *
      *  \param step number and direction of steps according the current point
@@ -181,14 +502,150 @@ class deserializer
     /** \brief last error code */
     uint8_t errcode;
   private:
+    /** \brief   load the value by one unaligned read
+     *
+     *  \tparam SWAP reverse byte order
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current deserializer object */
+    template <bool SWAP, typename TYPE>
+    deserializer& get(TYPE& val)
+    { if (pos + sizeof(TYPE) > buffer_size)
+      { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERRUN; }
+
+        return *this; }
+
+      memcpy(&val, (uint8_t*)buffer + pos, sizeof(TYPE));
+
+      if (SWAP) { byte_swap<sizeof(TYPE)>(&val); }
+
+      pos += sizeof(TYPE);
+      return *this; }
+
+    /** \brief   read LEB128 varint
+     *
+     *  \param val reference to store the value
+     *
+     *  \return the varint is read */
+    bool varint(uint64_t& val);
+
+    /** \brief   read bit field
+     *
+     *  \param val  reference to store the value
+     *  \param bits size of the field
+     *
+     *  \return the field is read */
+    bool field(uint32_t& val, uint8_t bits);
+
     /** \brief current byte order
-     *  \note true for straign system order, false for reverse order */
+     *  \note false for straight system order, true for reverse order */
     bool byte_order;
 
     /** \brief pointer to the external buffer where the sequence is placed */
     void* buffer;
 
     /** \brief size of the external buffer */
-    uint32_t buffer_size; };
+    uint32_t buffer_size;
+
+    /** \brief number of the used bits of the last bit field byte */
+    uint8_t bit;
+
+    /** \brief position after the last bit field byte */
+    uint32_t bits_at; };
+
+/** \brief   record of the sequence that is already checked
+ *  \warning reads are not checked, the view must be checked by operator
+ *           bool before the reading and the fields must fit its size */
+class deserializer_view
+{ public:
+    /** \brief constructor
+     *
+     *  \param data       pointer to the record, null for invalid view
+     *  \param size       size of the record
+     *  \param byte_order reverse byte order of v() */
+    deserializer_view(const uint8_t* data, uint32_t size, bool byte_order)
+      : pos(0), size(size), data(data), byte_order(byte_order)
+    {}
+
+    /** \brief the record is in the sequence */
+    explicit operator bool() const { return data != nullptr; }
+
+    /** \brief extracts the value in current byte order
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current view */
+    template <typename TYPE>
+    deserializer_view& v(TYPE& val)
+    { return (byte_order) ? get<true>(val) : get<false>(val); }
+
+    /** \brief extracts the value in big endian order
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current view */
+    template <typename TYPE>
+    deserializer_view& be(TYPE& val) { return get<!HOST_BIG_ENDIAN>(val); }
+
+    /** \brief extracts the value in little endian order
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current view */
+    template <typename TYPE>
+    deserializer_view& le(TYPE& val) { return get<HOST_BIG_ENDIAN>(val); }
+
+    /** \brief extracts raw array
+     *
+     *  \param buf pointer to the buffer for array
+     *  \param len size of array
+     *
+     *  \return reference to the current view */
+    deserializer_view& a(void* buf, uint32_t len)
+    { memcpy(buf, data + pos, len);
+      pos += len;
+      return *this; }
+
+    /** \brief skip the bytes of the record
+     *
+     *  \param len number of the bytes
+     *
+     *  \return reference to the current view */
+    deserializer_view& skip(uint32_t len)
+    { pos += len;
+      return *this; }
+
+    /** \brief current position inside of the record */
+    uint32_t pos;
+
+    /** \brief size of the record */
+    uint32_t size;
+
+  private:
+    /** \brief   load the value without checks
+     *
+     *  \tparam SWAP reverse byte order
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current view */
+    template <bool SWAP, typename TYPE>
+    deserializer_view& get(TYPE& val)
+    { memcpy(&val, data + pos, sizeof(TYPE));
+
+      if (SWAP) { byte_swap<sizeof(TYPE)>(&val); }
+
+      pos += sizeof(TYPE);
+      return *this; }
+
+    /** \brief pointer to the record */
+    const uint8_t* data;
+
+    /** \brief reverse byte order of v() */
+    bool byte_order; };
 
 #endif // SERIALIZER_HPP
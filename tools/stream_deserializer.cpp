@@ -0,0 +1,127 @@
+/** \file stream_deserializer.cpp
+ *  \details implementation of the deserializer of the chained pieces */
+
+#include <cstdint>
+#include <cstring>
+#include "tools/stream_deserializer.hpp"
+#include "core/errcode.hpp"
+
+stream_deserializer::stream_deserializer(void* stage, uint32_t stage_size)
+  : pos(0),
+    errcode(ERR_OK),
+    used(0),
+    seg(0),
+    off(0),
+    total(0),
+    mark(0),
+    mark_seg(0),
+    mark_off(0),
+    stage((uint8_t*)stage),
+    stage_size(stage_size)
+{}
+
+stream_deserializer& stream_deserializer::add(const void* data, uint32_t size)
+{ if (!size) { return *this; }
+
+  if (used >= STREAM_SEGMENTS)
+  { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERFLOW; }
+
+    return *this; }
+
+  segments[used].data = (const uint8_t*)data;
+  segments[used].size = size;
+  used++;
+  total += size;
+  return *this; }
+
+uint32_t stream_deserializer::pull(i_pipe& p)
+{ if (!stage || used > 1 || (used && segments[0].data != stage))
+  { if (errcode == ERR_OK) { errcode = ERR_INVALID_ARGUMENT; }
+
+    return 0; }
+
+  // drop the committed data, only the rest of the message is moved
+  if (mark)
+  { memmove(stage, stage + mark, total - mark);
+    total -= mark;
+    pos -= mark;
+    off = pos;
+    mark = 0;
+    mark_off = 0; }
+
+  // uncommitted message fills the stage, it will never be complete
+  if (total == stage_size)
+  { if (errcode == ERR_OK) { errcode = ERR_BUFFER_OVERFLOW; }
+
+    return 0; }
+
+  uint32_t pulled = p.read(stage + total, stage_size - total);
+  total += pulled;
+  segments[0].data = stage;
+  segments[0].size = total;
+  used = (total) ? 1 : 0;
+  return pulled; }
+
+void stream_deserializer::clear()
+{ used = 0;
+  seg = 0;
+  off = 0;
+  total = 0;
+  pos = 0;
+  mark = 0;
+  mark_seg = 0;
+  mark_off = 0;
+  errcode = ERR_OK; }
+
+stream_deserializer& stream_deserializer::a(void* buf, uint32_t len)
+{ take(buf, len);
+  return *this; }
+
+stream_deserializer& stream_deserializer::skip(uint32_t len)
+{ take(nullptr, len);
+  return *this; }
+
+uint32_t stream_deserializer::available() const
+{ return total - pos; }
+
+uint32_t stream_deserializer::commit()
+{ uint32_t consumed = pos - mark;
+  mark = pos;
+  mark_seg = seg;
+  mark_off = off;
+  return consumed; }
+
+stream_deserializer& stream_deserializer::rollback()
+{ pos = mark;
+  seg = mark_seg;
+  off = mark_off;
+  errcode = ERR_OK;
+  return *this; }
+
+bool stream_deserializer::take(void* dst, uint32_t len)
+{ if (errcode != ERR_OK) { return false; }
+
+  if (len > total - pos)
+  { errcode = ERR_NOT_READY;
+    return false; }
+
+  uint8_t* d = (uint8_t*)dst;
+  pos += len;
+
+  while (len)
+  { if (off == segments[seg].size)
+    { seg++;
+      off = 0; }
+
+    uint32_t piece = segments[seg].size - off;
+
+    if (piece > len) { piece = len; }
+
+    if (d)
+    { memcpy(d, segments[seg].data + off, piece);
+      d += piece; }
+
+    off += piece;
+    len -= piece; }
+
+  return true; }
@@ -0,0 +1,217 @@
+/** \file    stream_deserializer.hpp
+ *  \brief   deserializer of the data that isn't placed in one buffer
+ *  \details the sequence is a chain of the pieces: two parts of the circular
+ *           buffer, several buffers or the data that is pulled from the pipe.
+ *           values are read right from the pieces without copying of the
+ *           whole message to the linear buffer. if the message isn't
+ *           complete yet the reading is rolled back to the last committed
+ *           point and repeated when more data arrives */
+
+#ifndef STREAM_DESERIALIZER_HPP
+#define STREAM_DESERIALIZER_HPP
+
+#include <cstdint>
+#include <cstring>
+#include "containers/circular_buffer.hpp"
+#include "core/errcode.hpp"
+#include "core/pipe.hpp"
+#include "tools/serializer.hpp"
+
+/** \brief maximum number of the pieces in the chain */
+#ifndef STREAM_SEGMENTS
+  #define STREAM_SEGMENTS 4
+#endif
+
+/** \brief contiguous piece of the sequence */
+class stream_segment
+{ public:
+    /** \brief pointer to the data */
+    const uint8_t* data;
+
+    /** \brief size of the data */
+    uint32_t size; };
+
+/** \brief   tool to parse the sequence from several pieces
+ *  \details typical usage with the pipe:
+ *
+ *  \code
+ *  in.pull(pipe);
+ *  in.be<uint16_t>(addr).be<uint32_t>(count);
+ *
+ *  if (in.errcode == ERR_NOT_READY) { in.rollback(); return; }
+ *
+ *  in.commit();
+ *  \endcode */
+class stream_deserializer
+{ public:
+    /** \brief constructor
+     *
+     *  \param stage      buffer to keep the data pulled from the pipe, may
+     *                    be null if pull() isn't used
+     *  \param stage_size size of the buffer */
+    explicit stream_deserializer(void* stage = nullptr,
+                                 uint32_t stage_size = 0);
+
+    /** \brief append the piece to the end of the sequence
+     *
+     *  \param data pointer to the piece
+     *  \param size size of the piece
+     *
+     *  \return reference to the current object */
+    stream_deserializer& add(const void* data, uint32_t size);
+
+    /** \brief   append all of the data of the circular buffer
+     *  \details the data stays in the buffer, remove it with pop_tail() by
+     *           the value that commit() returns. the pieces point to the
+     *           old place of the data after that, so call clear() and add()
+     *           again before the next reading
+     *
+     *  \param ring circular buffer
+     *
+     *  \return reference to the current object */
+    template <uint32_t VOLUME>
+    stream_deserializer& add(circular_buffer<uint8_t, VOLUME>& ring)
+    { uint32_t first = 0;
+      uint32_t second = 0;
+      uint8_t* data = ring.segment(0, &first);
+      add(data, first);
+      data = ring.segment(first, &second);
+      return add(data, second); }
+
+    /** \brief   pull available data from the pipe to the stage
+     *  \details committed data is dropped from the stage first, so only the
+     *           incomplete message is moved. the stage must be the only piece
+     *           of the sequence
+     *  \details ERR_BUFFER_OVERFLOW is set if the incomplete message fills
+     *           the whole stage, the stage is too small for it
+     *
+     *  \param p pipe
+     *
+     *  \return number of the pulled bytes */
+    uint32_t pull(i_pipe& p);
+
+    /** \brief drop all of the pieces */
+    void clear();
+
+    /** \brief   extracts the value in the byte order of the host
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current object */
+    template <typename TYPE>
+    stream_deserializer& v(TYPE& val) { return get<false>(val); }
+
+    /** \brief   extracts the value in big endian order
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current object */
+    template <typename TYPE>
+    stream_deserializer& be(TYPE& val) { return get<!HOST_BIG_ENDIAN>(val); }
+
+    /** \brief   extracts the value in little endian order
+     *
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current object */
+    template <typename TYPE>
+    stream_deserializer& le(TYPE& val) { return get<HOST_BIG_ENDIAN>(val); }
+
+    /** \brief extracts array from the sequence
+     *
+     *  \param buf pointer to the buffer for array
+     *  \param len size of array in the sequence
+     *
+     *  \return reference to the current object */
+    stream_deserializer& a(void* buf, uint32_t len);
+
+    /** \brief skip the bytes of the sequence
+     *
+     *  \param len number of the bytes
+     *
+     *  \return reference to the current object */
+    stream_deserializer& skip(uint32_t len);
+
+    /** \brief number of the bytes that are not read yet
+     *
+     *  \return number of the bytes */
+    uint32_t available() const;
+
+    /** \brief   mark all of the read data as consumed
+     *  \details rollback() returns to this point later
+     *
+     *  \return number of the bytes consumed since previous commit */
+    uint32_t commit();
+
+    /** \brief   return to the last committed point
+     *  \details error code is cleared, use it when the message is incomplete
+     *
+     *  \return reference to the current object */
+    stream_deserializer& rollback();
+
+    /** \brief current position from the start of the sequence */
+    uint32_t pos;
+
+    /** \brief   last error code
+     *  \details ERR_NOT_READY if the sequence is too short */
+    uint8_t errcode;
+
+  private:
+    /** \brief   load the value from the sequence
+     *
+     *  \tparam SWAP reverse byte order
+     *  \tparam TYPE type of the variable
+     *  \param  val  reference to the variable
+     *
+     *  \return reference to the current object */
+    template <bool SWAP, typename TYPE>
+    stream_deserializer& get(TYPE& val)
+    { if (!take(&val, sizeof(TYPE))) { return *this; }
+
+      if (SWAP) { byte_swap<sizeof(TYPE)>(&val); }
+
+      return *this; }
+
+    /** \brief   copy the bytes from the sequence
+     *  \details nothing is read if the sequence is too short
+     *
+     *  \param dst pointer to the destination, null to skip the bytes
+     *  \param len number of the bytes
+     *
+     *  \return the bytes are read */
+    bool take(void* dst, uint32_t len);
+
+    /** \brief pieces of the sequence */
+    stream_segment segments[STREAM_SEGMENTS];
+
+    /** \brief number of the pieces */
+    uint8_t used;
+
+    /** \brief piece of the current position */
+    uint8_t seg;
+
+    /** \brief offset of the current position inside of the piece */
+    uint32_t off;
+
+    /** \brief size of the whole sequence */
+    uint32_t total;
+
+    /** \brief committed position */
+    uint32_t mark;
+
+    /** \brief piece of the committed position */
+    uint8_t mark_seg;
+
+    /** \brief offset of the committed position inside of the piece */
+    uint32_t mark_off;
+
+    /** \brief buffer for the data from the pipe */
+    uint8_t* stage;
+
+    /** \brief size of the stage */
+    uint32_t stage_size; };
+
+#endif // STREAM_DESERIALIZER_HPP